@@ -0,0 +1,51 @@
+#include "../includes/arena.hpp"
+
+#include <algorithm>
+
+namespace TerreateCore {
+namespace Core {
+using namespace TerreateCore::Defines;
+
+Size FrameArena::GetCapacity() const {
+  Size capacity = 0;
+  for (Block const &block : mBlocks) {
+    capacity += block.size;
+  }
+  return capacity;
+}
+
+void *FrameArena::Allocate(Size const &size, Size const &alignment) {
+  while (mBlock < mBlocks.size()) {
+    Block &block = mBlocks[mBlock];
+    Size const base = (Size)block.data.get();
+    Size const aligned = (base + mOffset + alignment - 1) & ~(alignment - 1);
+    Size const offset = aligned - base;
+    if (offset + size <= block.size) {
+      mOffset = offset + size;
+      mUsed += size;
+      return block.data.get() + offset;
+    }
+
+    ++mBlock;
+    mOffset = 0;
+  }
+
+  // Oversized requests get a block of their own.
+  Size const blockSize = std::max(mBlockSize, size + alignment);
+  mBlocks.push_back({std::make_unique<Ubyte[]>(blockSize), blockSize});
+  mBlock = mBlocks.size() - 1;
+  mOffset = 0;
+  return this->Allocate(size, alignment);
+}
+
+void FrameArena::Reset() {
+  for (auto it = mDestructors.rbegin(); it != mDestructors.rend(); ++it) {
+    it->destroy(it->object);
+  }
+  mDestructors.clear();
+  mBlock = 0;
+  mOffset = 0;
+  mUsed = 0;
+}
+} // namespace Core
+} // namespace TerreateCore
@@ -1,15 +1,48 @@
 #include "../includes/core.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace TerreateCore {
 namespace Core {
 using namespace TerreateCore::Defines;
 Bool GLFW_INITIALIZED = false;
 Bool GLAD_INITIALIZED = false;
 
-Bool Clock::IsElapsed(Float const &time) {
-  Float const now = glfwGetTime();
-  Float const delta = now - mLastTime;
-  if (delta >= time) {
+Ulong Clock::GetTime() const {
+  auto const elapsed = std::chrono::steady_clock::now() - mStart;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+      .count();
+}
+
+Double Clock::GetAlpha() const {
+  if (mFixedStep == 0) {
+    return 0.0;
+  }
+  return (Double)mAccumulator / mFixedStep;
+}
+
+void Clock::SetFixedStep(Double const &step, Double const &maxAccumulated) {
+  if (step <= 0.0) {
+    TC_THROW("Fixed step must be positive.");
+  }
+  mFixedStep = step * sSecond;
+  mMaxAccumulated = maxAccumulated * sSecond;
+  mAccumulator = 0;
+}
+
+Bool Clock::ConsumeStep() {
+  if (mFixedStep == 0 || mAccumulator < mFixedStep) {
+    return false;
+  }
+  mAccumulator -= mFixedStep;
+  return true;
+}
+
+Bool Clock::IsElapsed(Double const &time) {
+  Ulong const now = this->GetTime();
+  Ulong const delta = now - mLastTime;
+  if (delta >= time * sSecond) {
     mLastTime = now;
     mDeltaTime = delta;
     return true;
@@ -17,6 +50,71 @@ Bool Clock::IsElapsed(Float const &time) {
   return false;
 }
 
+void Clock::WaitUntil(Ulong const &deadline) {
+  Ulong now = this->GetTime();
+  if (now + mSpinMargin < deadline) {
+    Ulong const request = deadline - now - mSpinMargin;
+    std::this_thread::sleep_for(std::chrono::nanoseconds(request));
+    Ulong const woken = this->GetTime();
+    Ulong const error = woken - now > request ? woken - now - request : 0;
+    // Spinning for twice the average oversleep absorbs most outliers.
+    mSleepError = (mSleepError * 7 + error) / 8;
+    mSpinMargin = std::clamp(mSleepError * 2, sMinSpin, sMaxSpin);
+    now = woken;
+  }
+
+  while (now < deadline) {
+    now = this->GetTime();
+  }
+}
+
+void Clock::RecordFrame(Ulong const &now) {
+  mDeltaTime = now - mFrameStart;
+  mFrameStart = now;
+  if (mFixedStep > 0) {
+    mAccumulator = std::min(mAccumulator + mDeltaTime, mMaxAccumulated);
+  }
+
+  Double const time = (Double)mDeltaTime / sSecond;
+  FrameStats &stats = mStats;
+  ++stats.frames;
+  stats.last = time;
+  stats.min = stats.frames == 1 ? time : std::min(stats.min, time);
+  stats.max = std::max(stats.max, time);
+  // Welford's online algorithm.
+  Double const delta = time - stats.mean;
+  stats.mean += delta / stats.frames;
+  stats.squares += delta * (time - stats.mean);
+  stats.deviation = std::sqrt(stats.squares / stats.frames);
+}
+
+void Clock::Frame(Uint const &fps) {
+  if (fps == 0) {
+    mPeriod = 0;
+    this->RecordFrame(this->GetTime());
+    return;
+  }
+
+  Ulong const period = sSecond / fps;
+  if (period != mPeriod) {
+    mPeriod = period;
+    mNextFrame = mFrameStart + period;
+  }
+
+  if (this->GetTime() > mNextFrame) {
+    ++mStats.missed;
+  } else {
+    this->WaitUntil(mNextFrame);
+  }
+
+  Ulong const now = this->GetTime();
+  this->RecordFrame(now);
+  mNextFrame += period;
+  if (mNextFrame <= now) {
+    mNextFrame = now + period;
+  }
+}
+
 void Initialize() {
   if (!glfwInit()) {
     TC_THROW("Failed to initialize GLFW");
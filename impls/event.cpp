@@ -1,49 +1,782 @@
 #include "../includes/event.hpp"
 
+#include <algorithm>
+
 namespace TerreateCore {
 namespace Event {
 using namespace TerreateCore::Defines;
 
-void EventSystem::Register(Str const &event, EventCallback const &callback) {
-  if (mCallbacks.find(event) == mCallbacks.end()) {
-    mCallbacks[event] = Vec<EventCallback>();
+Index HandlerList::Add(EventHandler const &handler,
+                       Index const &subscription) {
+  handlers.push_back(handler);
+  subscriptions.push_back(subscription);
+  removed.push_back(false);
+  metrics.emplace_back();
+  return handlers.size() - 1;
+}
+
+Index HandlerList::Remove(Index const &position) {
+  Index const last = handlers.size() - 1;
+  Index moved = sNoMove;
+  if (position != last) {
+    // The moved entry may itself be a pending removal, so its id is kept to
+    // fix up its position either way.
+    handlers[position] = std::move(handlers[last]);
+    subscriptions[position] = subscriptions[last];
+    removed[position] = removed[last];
+    metrics[position] = metrics[last];
+    moved = subscriptions[position];
+  }
+  handlers.pop_back();
+  subscriptions.pop_back();
+  removed.pop_back();
+  metrics.pop_back();
+  return moved;
+}
+
+EventSlot &EventSystem::AcquireSlot(EventID const &event) {
+  if (event >= mSlots.size()) {
+    LockGuard<Mutex> lock(mRegistryMutex);
+    if (event >= mEventNames.size()) {
+      TC_THROW("Unknown event id.");
+    }
+
+    while (mSlots.size() <= event) {
+      EventSlot &slot = mSlots.emplace_back();
+      slot.name = mEventNames[mSlots.size() - 1];
+    }
+  }
+  return mSlots[event];
+}
+
+EventID EventSystem::GetTypeEventID(Index const &type, char const *name) {
+  {
+    LockGuard<Mutex> lock(mRegistryMutex);
+    if (type < mTypeIDs.size() && mTypeIDs[type] != sNoEvent) {
+      return mTypeIDs[type];
+    }
+  }
+
+  EventID const id = this->GetEventID(name);
+  LockGuard<Mutex> lock(mRegistryMutex);
+  if (type >= mTypeIDs.size()) {
+    mTypeIDs.resize(type + 1, sNoEvent);
+  }
+  mTypeIDs[type] = id;
+  return id;
+}
+
+EventSystem::~EventSystem() {
+  // Drop the thread-local entries of this system from every thread.
+  for (PublishBuffer &buffer : mBuffers) {
+    if (Shared<ThreadBuffers> owner = buffer.owner.lock()) {
+      LockGuard<Mutex> lock(owner->mutex);
+      owner->buffers.erase(mInstance);
+    }
+  }
+  for (Atomic<Atomic<Bool> *> &chunk : mCoalesceFlags) {
+    delete[] chunk.load();
+  }
+}
+
+Index EventSystem::NextTypeIndex() {
+  static Atomic<Index> next = 0;
+  return next.fetch_add(1);
+}
+
+Ulong EventSystem::NextInstance() {
+  // Ids are never reused, so stale thread-local entries are never matched.
+  static Atomic<Ulong> next = 1;
+  return next.fetch_add(1);
+}
+
+EventID EventSystem::GetEventID(Str const &event) {
+  LockGuard<Mutex> lock(mRegistryMutex);
+  auto it = mEventIDs.find(event);
+  if (it != mEventIDs.end()) {
+    return it->second;
   }
 
-  mCallbacks[event].push_back(callback);
+  EventID const id = mEventNames.size();
+  mEventIDs.emplace(event, id);
+  mEventNames.push_back(event);
+  return id;
 }
 
-void EventSystem::AddTrigger(Str const &event, EventCallback const &callback) {
-  if (mTriggers.find(event) == mTriggers.end()) {
-    mTriggers[event] = Queue<EventCallback>();
+Str EventSystem::GetEventName(EventID const &event) {
+  LockGuard<Mutex> lock(mRegistryMutex);
+  if (event >= mEventNames.size()) {
+    TC_THROW("Unknown event id.");
+  }
+  return mEventNames[event];
+}
+
+void EventSystem::DispatchConcurrent() {
+  Bool const metrics = mMetricsEnabled;
+  for (EventID const &event : mPendingSlots) {
+    EventSlot &slot = mSlots[event];
+    for (Index i = 0; i < slot.concurrent.GetSize(); ++i) {
+      EventHandler const &handler = slot.concurrent.handlers[i];
+      HandlerMetrics &handlerMetrics = slot.concurrent.metrics[i];
+      auto run = [&slot, &handler, &handlerMetrics, metrics] {
+        for (void const *payload : slot.pending) {
+          if (!metrics) {
+            handler(slot.name, payload);
+            continue;
+          }
+          Ulong const start = GetTimestamp();
+          handler(slot.name, payload);
+          handlerMetrics.Record(GetTimestamp() - start);
+        }
+      };
+      if (mJobSystem == nullptr) {
+        run();
+      } else {
+        mJobSystem->Adopt(new Job::SimpleJob(run), &mDispatchCounter);
+      }
+    }
+  }
+}
+
+HandlerList &EventSystem::GetHandlerList(Subscription const &subscription) {
+  if (subscription.pattern) {
+    return mPatterns[subscription.event].handlers;
+  }
+  EventSlot &slot = mSlots[subscription.event];
+  return subscription.concurrent ? slot.concurrent : slot.ordered;
+}
+
+Str const &EventSystem::GetSubscriptionName(Subscription const &subscription) {
+  if (subscription.pattern) {
+    return mPatterns[subscription.event].pattern;
+  }
+  return mSlots[subscription.event].name;
+}
+
+Index EventSystem::AcquirePattern(Str const &pattern) {
+  auto it = mPatternIDs.find(pattern);
+  if (it != mPatternIDs.end()) {
+    return it->second;
+  }
+
+  Index node = 0;
+  Stream stream(pattern);
+  Str segment;
+  while (std::getline(stream, segment, '.')) {
+    Index next = sNoEntry;
+    if (segment == "*") {
+      next = mTopicNodes[node].star;
+    } else if (segment == "#") {
+      next = mTopicNodes[node].hash;
+    } else {
+      auto child = mTopicNodes[node].children.find(segment);
+      next = child == mTopicNodes[node].children.end() ? sNoEntry
+                                                        : child->second;
+    }
+
+    if (next == sNoEntry) {
+      next = mTopicNodes.size();
+      mTopicNodes.emplace_back();
+      if (segment == "*") {
+        mTopicNodes[node].star = next;
+      } else if (segment == "#") {
+        mTopicNodes[node].hash = next;
+      } else {
+        mTopicNodes[node].children.emplace(segment, next);
+      }
+    }
+    node = next;
+  }
+
+  Index const id = mPatterns.size();
+  PatternSlot &slot = mPatterns.emplace_back();
+  slot.pattern = pattern;
+  mPatternIDs.emplace(pattern, id);
+  mTopicNodes[node].patterns.push_back(id);
+  // Cached resolutions are rebuilt lazily.
+  ++mTopicVersion;
+  return id;
+}
+
+void EventSystem::MatchTopic(Index const &node, Vec<Str> const &segments,
+                             Index const &depth, Vec<Index> &matches) const {
+  TopicNode const &topic = mTopicNodes[node];
+  if (topic.hash != sNoEntry) {
+    // '#' matches zero or more segments.
+    for (Index next = depth; next <= segments.size(); ++next) {
+      this->MatchTopic(topic.hash, segments, next, matches);
+    }
+  }
+
+  if (depth == segments.size()) {
+    matches.insert(matches.end(), topic.patterns.begin(),
+                   topic.patterns.end());
+    return;
   }
 
-  mTriggers[event].push(callback);
+  auto child = topic.children.find(segments[depth]);
+  if (child != topic.children.end()) {
+    this->MatchTopic(child->second, segments, depth + 1, matches);
+  }
+  if (topic.star != sNoEntry) {
+    this->MatchTopic(topic.star, segments, depth + 1, matches);
+  }
+}
+
+Vec<Index> const &EventSystem::ResolvePatterns(EventID const &event) {
+  if (event >= mResolved.size()) {
+    mResolved.resize(event + 1);
+  }
+
+  ResolvedTopic &resolved = mResolved[event];
+  if (resolved.version == mTopicVersion) {
+    return resolved.patterns;
+  }
+
+  Vec<Str> segments;
+  Stream stream(mSlots[event].name);
+  Str segment;
+  while (std::getline(stream, segment, '.')) {
+    segments.push_back(segment);
+  }
+
+  resolved.patterns.clear();
+  this->MatchTopic(0, segments, 0, resolved.patterns);
+  std::sort(resolved.patterns.begin(), resolved.patterns.end());
+  resolved.patterns.erase(
+      std::unique(resolved.patterns.begin(), resolved.patterns.end()),
+      resolved.patterns.end());
+  resolved.version = mTopicVersion;
+  return resolved.patterns;
+}
+
+void EventSystem::RunOrdered(HandlerList &list, Str const &name,
+                             void const *payload, Bool const &metrics) {
+  if (!metrics) {
+    for (Index i = 0; i < list.GetSize(); ++i) {
+      if (!list.removed[i]) {
+        list.handlers[i](name, payload);
+      }
+    }
+    return;
+  }
+
+  Ulong previous = GetTimestamp();
+  for (Index i = 0; i < list.GetSize(); ++i) {
+    if (!list.removed[i]) {
+      list.handlers[i](name, payload);
+      Ulong const now = GetTimestamp();
+      list.metrics[i].Record(now - previous);
+      previous = now;
+    }
+  }
+}
+
+SubscriptionID EventSystem::Subscribe(EventID const &event,
+                                      EventHandler const &handler,
+                                      DispatchPolicy const &policy) {
+  this->AcquireSlot(event);
+  return this->AddSubscription(event, false, handler, policy);
+}
+
+Bool EventSystem::IsTopicPattern(Str const &event) {
+  Stream stream(event);
+  Str segment;
+  while (std::getline(stream, segment, '.')) {
+    if (segment == "*" || segment == "#") {
+      return true;
+    }
+  }
+  return false;
+}
+
+SubscriptionID EventSystem::Register(Str const &event,
+                                     EventCallback const &callback,
+                                     DispatchPolicy const &policy) {
+  if (!IsTopicPattern(event)) {
+    return this->Register(this->GetEventID(event), callback, policy);
+  }
+
+  if (policy == DispatchPolicy::CONCURRENT) {
+    TC_THROW("Topic patterns only support ordered dispatch.");
+  }
+  return this->AddSubscription(
+      this->AcquirePattern(event), true,
+      [callback](Str const &name, void const *) { callback(name); }, policy);
+}
+
+SubscriptionID EventSystem::AddSubscription(EventID const &target,
+                                            Bool const &pattern,
+                                            EventHandler const &handler,
+                                            DispatchPolicy const &policy) {
+  Index index = 0;
+  if (mFreeSubscriptions.empty()) {
+    index = mSubscriptions.size();
+    mSubscriptions.emplace_back();
+  } else {
+    index = mFreeSubscriptions.back();
+    mFreeSubscriptions.pop_back();
+  }
+
+  Subscription &subscription = mSubscriptions[index];
+  subscription.event = target;
+  subscription.pattern = pattern;
+  subscription.concurrent = policy == DispatchPolicy::CONCURRENT;
+  subscription.active = true;
+  subscription.attached = false;
+  if (mDispatching) {
+    mDeferredAdds.push_back({index, handler});
+  } else {
+    this->Attach(index, handler);
+  }
+  return ((SubscriptionID)subscription.generation << 32) | index;
+}
+
+void EventSystem::Attach(Index const &subscription,
+                         EventHandler const &handler) {
+  Subscription &entry = mSubscriptions[subscription];
+  HandlerList &list = this->GetHandlerList(entry);
+  entry.position = list.Add(handler, subscription);
+  entry.attached = true;
+}
+
+void EventSystem::Detach(Index const &subscription) {
+  Subscription &entry = mSubscriptions[subscription];
+  if (entry.attached) {
+    HandlerList &list = this->GetHandlerList(entry);
+    Index const moved = list.Remove(entry.position);
+    if (moved != HandlerList::sNoMove) {
+      mSubscriptions[moved].position = entry.position;
+    }
+    entry.attached = false;
+  }
+  mFreeSubscriptions.push_back(subscription);
+}
+
+void EventSystem::ApplyDeferred() {
+  for (Index const &subscription : mDeferredRemovals) {
+    this->Detach(subscription);
+  }
+  mDeferredRemovals.clear();
+
+  for (auto const &[subscription, handler] : mDeferredAdds) {
+    if (mSubscriptions[subscription].active) {
+      this->Attach(subscription, handler);
+    }
+  }
+  mDeferredAdds.clear();
+}
+
+HandlerMetrics *EventSystem::FindHandlerMetrics(Index const &subscription) {
+  Subscription const &entry = mSubscriptions[subscription];
+  if (!entry.attached) {
+    return nullptr;
+  }
+  return &this->GetHandlerList(entry).metrics[entry.position];
+}
+
+Ulong EventSystem::GetTimestamp() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void EventSystem::EnableMetrics(Double const &dumpInterval) {
+  mDumpInterval = dumpInterval;
+  mLastDump = GetTimestamp();
+  mMetricsEnabled = true;
+}
+
+void EventSystem::ResetMetrics() {
+  mEventMetrics.clear();
+  mQueueDepth.Clear();
+  for (EventSlot &slot : mSlots) {
+    std::fill(slot.ordered.metrics.begin(), slot.ordered.metrics.end(),
+              HandlerMetrics());
+    std::fill(slot.concurrent.metrics.begin(), slot.concurrent.metrics.end(),
+              HandlerMetrics());
+  }
+  for (PatternSlot &slot : mPatterns) {
+    std::fill(slot.handlers.metrics.begin(), slot.handlers.metrics.end(),
+              HandlerMetrics());
+  }
+}
+
+EventMetrics EventSystem::GetMetrics(EventID const &event) const {
+  if (event >= mEventMetrics.size()) {
+    return EventMetrics();
+  }
+  return mEventMetrics[event];
+}
+
+HandlerMetrics
+EventSystem::GetHandlerMetrics(SubscriptionID const &subscription) {
+  Index const index = subscription & 0xFFFFFFFF;
+  if (index >= mSubscriptions.size() || !mSubscriptions[index].active ||
+      mSubscriptions[index].generation != (subscription >> 32)) {
+    return HandlerMetrics();
+  }
+
+  HandlerMetrics const *metrics = this->FindHandlerMetrics(index);
+  return metrics == nullptr ? HandlerMetrics() : *metrics;
+}
+
+Str EventSystem::DumpMetrics() {
+  Stream report;
+  report << "Queue depth: p50 " << mQueueDepth.GetPercentile(0.5) << " p99 "
+         << mQueueDepth.GetPercentile(0.99) << " max " << mQueueDepth.max
+         << "\n";
+  for (EventID event = 0; event < mEventMetrics.size(); ++event) {
+    EventMetrics const &metrics = mEventMetrics[event];
+    if (metrics.dispatched == 0) {
+      continue;
+    }
+    report << "Event " << mSlots[event].name << ": dispatched "
+           << metrics.dispatched << ", latency p50 "
+           << metrics.latency.GetPercentile(0.5) / 1000.0 << "us p99 "
+           << metrics.latency.GetPercentile(0.99) / 1000.0
+           << "us, handlers " << metrics.handlerTime / 1000.0 << "us\n";
+  }
+
+  // The most expensive handlers are the ones making frames spike.
+  Vec<Index> handlers;
+  for (Index i = 0; i < mSubscriptions.size(); ++i) {
+    if (mSubscriptions[i].active && mSubscriptions[i].attached) {
+      handlers.push_back(i);
+    }
+  }
+  std::sort(handlers.begin(), handlers.end(), [this](Index a, Index b) {
+    return this->FindHandlerMetrics(a)->total >
+           this->FindHandlerMetrics(b)->total;
+  });
+  for (Index const &index : handlers) {
+    Subscription const &entry = mSubscriptions[index];
+    HandlerMetrics const &metrics = *this->FindHandlerMetrics(index);
+    SubscriptionID const id = ((SubscriptionID)entry.generation << 32) | index;
+    report << "Handler " << id << " on " << this->GetSubscriptionName(entry)
+           << (entry.concurrent ? " (concurrent)" : "") << ": calls "
+           << metrics.calls << ", total " << metrics.total / 1000.0
+           << "us, max " << metrics.max / 1000.0 << "us\n";
+  }
+  return report.str();
+}
+
+Bool EventSystem::Unregister(SubscriptionID const &subscription) {
+  Index const index = subscription & 0xFFFFFFFF;
+  if (index >= mSubscriptions.size() || !mSubscriptions[index].active ||
+      mSubscriptions[index].generation != (subscription >> 32)) {
+    return false;
+  }
+
+  Subscription &entry = mSubscriptions[index];
+  entry.active = false;
+  ++entry.generation;
+  if (!mDispatching) {
+    this->Detach(index);
+    return true;
+  }
+
+  if (entry.attached) {
+    HandlerList &list = this->GetHandlerList(entry);
+    list.removed[entry.position] = true;
+  }
+  mDeferredRemovals.push_back(index);
+  return true;
+}
+
+void EventSystem::CollectTimers() {
+  {
+    LockGuard<Mutex> lock(mTimerMutex);
+    mTimers.Advance(this->ToTick(std::chrono::steady_clock::now()),
+                    mFiredTimers);
+  }
+  if (mFiredTimers.empty()) {
+    return;
+  }
+
+  LockGuard<Mutex> lock(mQueueMutex);
+  for (EventID const &event : mFiredTimers) {
+    this->PushEvent(event);
+  }
+  mFiredTimers.clear();
+}
+
+Ulong EventSystem::ToTick(
+    std::chrono::steady_clock::time_point const &time) const {
+  if (time <= mTimerEpoch) {
+    return 0;
+  }
+  return (time - mTimerEpoch) / sTimerTick;
+}
+
+void EventSystem::AddTrigger(EventID const &event,
+                             EventCallback const &callback) {
+  this->AcquireSlot(event).triggers.push(callback);
 }
 
 void EventSystem::ProcessEvents() {
-  UniqueLock<Mutex> lock(mQueueMutex);
-  while (!mEventQueue.empty()) {
-    Str event = mEventQueue.front();
-    mEventQueue.pop();
-    if (mCallbacks.find(event) != mCallbacks.end()) {
-      for (EventCallback const &callback : mCallbacks[event]) {
-        callback(event);
+  this->CollectTimers();
+
+  Index frame = 0;
+  {
+    LockGuard<Mutex> lock(mQueueMutex);
+    mDispatchQueue.swap(mEventQueue);
+    for (EventID const &event : mCoalescedEvents) {
+      mCoalescedEntries[event] = sNoEntry;
+    }
+    mCoalescedEvents.clear();
+    frame = mArenaIndex;
+    mArenaIndex = 1 - mArenaIndex;
+  }
+  this->MergeBuffers();
+
+  Bool const metrics = mMetricsEnabled;
+  if (metrics) {
+    mQueueDepth.Record(mDispatchQueue.size());
+  }
+
+  mDispatching = true;
+  // Concurrent callbacks are started first so they overlap ordered ones.
+  for (QueuedEvent const &queued : mDispatchQueue) {
+    if (queued.event < mSlots.size() &&
+        mSlots[queued.event].concurrent.GetSize() > 0) {
+      EventSlot &slot = mSlots[queued.event];
+      if (slot.pending.empty()) {
+        mPendingSlots.push_back(queued.event);
       }
+      slot.pending.push_back(queued.payload);
     }
+  }
+  this->DispatchConcurrent();
 
-    if (mTriggers.find(event) != mTriggers.end()) {
-      while (!mTriggers[event].empty()) {
-        EventCallback callback = std::move(mTriggers[event].front());
-        mTriggers[event].pop();
-        callback(event);
+  for (QueuedEvent const &queued : mDispatchQueue) {
+    // Events without a slot have never had a callback registered, but may
+    // still match a wildcard subscription.
+    if (queued.event >= mSlots.size()) {
+      if (mPatterns.empty()) {
+        continue;
       }
+      this->AcquireSlot(queued.event);
+    }
+
+    EventSlot &slot = mSlots[queued.event];
+    Ulong start = 0;
+    if (metrics) {
+      if (queued.event >= mEventMetrics.size()) {
+        mEventMetrics.resize(queued.event + 1);
+      }
+      start = GetTimestamp();
+      ++mEventMetrics[queued.event].dispatched;
+      if (queued.publishedAt != 0) {
+        mEventMetrics[queued.event].latency.Record(start -
+                                                   queued.publishedAt);
+      }
+    }
+
+    this->RunOrdered(slot.ordered, slot.name, queued.payload, metrics);
+    if (!mPatterns.empty()) {
+      for (Index const &pattern : this->ResolvePatterns(queued.event)) {
+        this->RunOrdered(mPatterns[pattern].handlers, slot.name,
+                         queued.payload, metrics);
+      }
+    }
+
+    if (metrics) {
+      mEventMetrics[queued.event].handlerTime += GetTimestamp() - start;
+    }
+
+    while (!slot.triggers.empty()) {
+      EventCallback callback = std::move(slot.triggers.front());
+      slot.triggers.pop();
+      callback(slot.name);
+    }
+  }
+
+  if (mJobSystem != nullptr) {
+    mJobSystem->Wait(mDispatchCounter);
+  }
+  mDispatching = false;
+  this->ApplyDeferred();
+  for (EventID const &event : mPendingSlots) {
+    mSlots[event].pending.clear();
+  }
+  mPendingSlots.clear();
+
+  // All payloads of the frame are released at once. Capacity is kept for
+  // the swap of the next frame.
+  mDispatchQueue.clear();
+  mArenas[frame].Reset();
+  this->ReleaseBuffers();
+
+  if (metrics && mDumpInterval > 0.0 &&
+      GetTimestamp() - mLastDump >= mDumpInterval * 1e9) {
+    mLastDump = GetTimestamp();
+    Str const report = this->DumpMetrics();
+    if (mDumpSink) {
+      mDumpSink(report);
+    } else {
+      std::clog << report << std::flush;
     }
   }
 }
 
-void EventSystem::PublishEvent(Str const &event) {
+Ulong EventSystem::PublishAfter(EventID const &event, Double const &delay) {
+  auto const duration =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<Double>(delay));
+  return this->PublishAt(event, std::chrono::steady_clock::now() + duration);
+}
+
+Ulong EventSystem::PublishAt(
+    EventID const &event, std::chrono::steady_clock::time_point const &time) {
+  // Rounding up keeps events from firing before their time.
+  Ulong const tick =
+      this->ToTick(time + sTimerTick - std::chrono::nanoseconds(1));
+  LockGuard<Mutex> lock(mTimerMutex);
+  return mTimers.Add(tick, event);
+}
+
+Bool EventSystem::CancelTimer(Ulong const &timer) {
+  LockGuard<Mutex> lock(mTimerMutex);
+  return mTimers.Cancel(timer);
+}
+
+PublishBuffer &EventSystem::AcquireBuffer() {
+  struct CachedBuffer {
+    Ulong instance = 0;
+    PublishBuffer *buffer = nullptr;
+  };
+  // Instance ids are never reused, so a stale cache entry never matches.
+  thread_local CachedBuffer sLast;
+  thread_local Shared<ThreadBuffers> sBuffers =
+      std::make_shared<ThreadBuffers>();
+  if (sLast.instance == mInstance) {
+    return *sLast.buffer;
+  }
+
+  LockGuard<Mutex> threadLock(sBuffers->mutex);
+  PublishBuffer *&buffer = sBuffers->buffers[mInstance];
+  if (buffer == nullptr) {
+    LockGuard<Mutex> lock(mBufferMutex);
+    buffer = &mBuffers.emplace_back();
+    buffer->owner = sBuffers;
+  }
+  sLast = {mInstance, buffer};
+  return *buffer;
+}
+
+void EventSystem::MergeBuffers() {
+  auto const bySequence = [](QueuedEvent const &lhs, QueuedEvent const &rhs) {
+    return lhs.sequence < rhs.sequence;
+  };
+  LockGuard<Mutex> lock(mBufferMutex);
+  for (auto it = mBuffers.begin(); it != mBuffers.end();) {
+    PublishBuffer &buffer = *it;
+    // An exited thread publishes nothing more. Its arenas are free once
+    // its last events have been dispatched.
+    if (buffer.owner.expired() && buffer.events.empty()) {
+      it = mBuffers.erase(it);
+      continue;
+    }
+    ++it;
+
+    LockGuard<Mutex> bufferLock(buffer.mutex);
+    Size const merged = mDispatchQueue.size();
+    mDispatchQueue.insert(mDispatchQueue.end(), buffer.events.begin(),
+                          buffer.events.end());
+    buffer.events.clear();
+    buffer.frame = buffer.arenaIndex;
+    buffer.arenaIndex = 1 - buffer.arenaIndex;
+
+    // The queue and every buffer are already in sequence order, so runs
+    // are merged only when a shared event falls inside the buffer.
+    auto const middle = mDispatchQueue.begin() + merged;
+    if (merged > 0 && middle != mDispatchQueue.end() &&
+        bySequence(*middle, *(middle - 1))) {
+      std::inplace_merge(mDispatchQueue.begin(), middle,
+                         mDispatchQueue.end(), bySequence);
+    }
+  }
+
+  if (mTimeOrdered) {
+    std::stable_sort(mDispatchQueue.begin(), mDispatchQueue.end(),
+                     [](QueuedEvent const &lhs, QueuedEvent const &rhs) {
+                       return lhs.publishedAt < rhs.publishedAt;
+                     });
+  }
+}
+
+void EventSystem::ReleaseBuffers() {
+  // Publishers only touch the other arena, so no buffer lock is needed.
+  LockGuard<Mutex> lock(mBufferMutex);
+  for (PublishBuffer &buffer : mBuffers) {
+    buffer.arenas[buffer.frame].Reset();
+  }
+}
+
+void EventSystem::PushEvent(EventID const &event) {
+  if (this->IsCoalesced(event) &&
+      this->AcquireCoalesced(event) != nullptr) {
+    return;
+  }
+  mEventQueue.push_back(this->MakeQueued(event, nullptr));
+}
+
+QueuedEvent *EventSystem::AcquireCoalesced(EventID const &event) {
+  if (event >= mCoalescedEntries.size()) {
+    mCoalescedEntries.resize(event + 1, sNoEntry);
+  }
+
+  Index &entry = mCoalescedEntries[event];
+  if (entry != sNoEntry) {
+    return &mEventQueue[entry];
+  }
+
+  // The caller queues the first event of the frame at this position.
+  entry = mEventQueue.size();
+  mCoalescedEvents.push_back(event);
+  return nullptr;
+}
+
+Bool EventSystem::IsCoalesced(EventID const &event) const {
+  Index const chunk = event >> sFlagChunkBits;
+  if (chunk >= sNumFlagChunks) {
+    return false;
+  }
+
+  Atomic<Bool> const *flags =
+      mCoalesceFlags[chunk].load(std::memory_order_acquire);
+  return flags != nullptr &&
+         flags[event & (sFlagChunkSize - 1)].load(std::memory_order_relaxed);
+}
+
+void EventSystem::SetCoalescing(EventID const &event, Bool const &coalesce) {
+  Index const chunk = event >> sFlagChunkBits;
+  if (chunk >= sNumFlagChunks) {
+    TC_THROW("Event id is too large to coalesce.");
+  }
+
   LockGuard<Mutex> lock(mQueueMutex);
-  mEventQueue.push(event);
+  Atomic<Bool> *flags = mCoalesceFlags[chunk].load(std::memory_order_relaxed);
+  if (flags == nullptr) {
+    flags = new Atomic<Bool>[sFlagChunkSize]();
+    mCoalesceFlags[chunk].store(flags, std::memory_order_release);
+  }
+  flags[event & (sFlagChunkSize - 1)].store(coalesce,
+                                            std::memory_order_relaxed);
+}
+
+void EventSystem::PublishEvent(EventID const &event) {
+  // Only coalesced events take the shared lock.
+  if (this->IsCoalesced(event)) {
+    LockGuard<Mutex> lock(mQueueMutex);
+    this->PushEvent(event);
+    return;
+  }
+
+  PublishBuffer &buffer = this->AcquireBuffer();
+  LockGuard<Mutex> lock(buffer.mutex);
+  buffer.events.push_back(this->MakeBuffered(event, nullptr));
 }
 } // namespace Event
 } // namespace TerreateCore
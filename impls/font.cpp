@@ -16,6 +16,19 @@ Font::Font(Str const &path, Uint const &size) : mSize(size) {
   FT_Set_Pixel_Sizes(mFace, 0, size);
 }
 
+Font::Font(Vec<Ubyte> &&data, Uint const &size)
+    : mSize(size), mData(std::move(data)) {
+  if (FT_Init_FreeType(&mLibrary)) {
+    TC_THROW("Failed to initialize FreeType library.");
+  }
+
+  if (FT_New_Memory_Face(mLibrary, mData.data(), mData.size(), 0, &mFace)) {
+    TC_THROW("Failed to load font.");
+  }
+
+  FT_Set_Pixel_Sizes(mFace, 0, size);
+}
+
 Font::~Font() {
   FT_Done_Face(mFace);
   FT_Done_FreeType(mLibrary);
@@ -0,0 +1,191 @@
+#include "../includes/graph.hpp"
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Defines;
+
+void TaskGraph::Dispatch(Index const &index) {
+  Task &task = mTasks[index];
+  if (task.affinity == TaskAffinity::ANY) {
+    mSystem->Schedule(task.node.get());
+    return;
+  }
+
+  {
+    LockGuard<Mutex> lock(mCallerLock);
+    mCallerTasks.push_back(index);
+  }
+  mCallerCondition.notify_one();
+}
+
+void TaskGraph::RunTask(Index const &index) {
+  Task &task = mTasks[index];
+  task.timing.start = this->Now();
+  try {
+    task.function();
+  } catch (...) {
+    LockGuard<Mutex> lock(mCallerLock);
+    if (!mException) {
+      mException = std::current_exception();
+    }
+  }
+  task.timing.end = this->Now();
+
+  for (Index const &successor : task.successors) {
+    Ulong const target = mTasks[successor].numPredecessors * mRun;
+    if (mCounters[successor].fetch_add(1) + 1 == target) {
+      this->Dispatch(successor);
+    }
+  }
+
+  if (mRemaining.fetch_sub(1) == 1) {
+    LockGuard<Mutex> lock(mCallerLock);
+    mCallerCondition.notify_all();
+  }
+}
+
+Ulong TaskGraph::Now() const {
+  auto const elapsed = std::chrono::steady_clock::now() - mRunStart;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+Vec<Index> TaskGraph::GetCriticalPath() const {
+  Vec<Index> path;
+  if (mOrder.empty()) {
+    return path;
+  }
+
+  Vec<Ulong> cost(mTasks.size(), 0);
+  Vec<Index> next(mTasks.size(), mTasks.size());
+  for (auto it = mOrder.rbegin(); it != mOrder.rend(); ++it) {
+    Task const &task = mTasks[*it];
+    Ulong longest = 0;
+    for (Index const &successor : task.successors) {
+      if (cost[successor] > longest || next[*it] == mTasks.size()) {
+        longest = cost[successor];
+        next[*it] = successor;
+      }
+    }
+    cost[*it] = task.timing.GetDuration() + longest;
+  }
+
+  Index current = mRoots[0];
+  for (Index const &root : mRoots) {
+    if (cost[root] > cost[current]) {
+      current = root;
+    }
+  }
+
+  while (current != mTasks.size()) {
+    path.push_back(current);
+    current = next[current];
+  }
+  return path;
+}
+
+Index TaskGraph::AddTask(Str const &name, Function<void()> const &function,
+                         TaskAffinity const &affinity) {
+  Index const index = mTasks.size();
+  Task task;
+  task.name = name;
+  task.function = function;
+  task.affinity = affinity;
+  task.node = std::make_shared<TaskNode>(this, index);
+  task.node->SetName(name);
+  mTasks.push_back(std::move(task));
+  mCompiled = false;
+  return index;
+}
+
+void TaskGraph::AddEdge(Index const &before, Index const &after) {
+  if (before >= mTasks.size() || after >= mTasks.size()) {
+    TC_THROW("Task index is out of range.");
+  }
+
+  mTasks[before].successors.push_back(after);
+  mTasks[after].numPredecessors++;
+  mCompiled = false;
+}
+
+void TaskGraph::Compile() {
+  mRoots.clear();
+  mOrder.clear();
+  mOrder.reserve(mTasks.size());
+
+  Vec<Ulong> pending(mTasks.size());
+  for (Index i = 0; i < mTasks.size(); ++i) {
+    pending[i] = mTasks[i].numPredecessors;
+    if (pending[i] == 0) {
+      mRoots.push_back(i);
+      mOrder.push_back(i);
+    }
+  }
+
+  for (Index i = 0; i < mOrder.size(); ++i) {
+    for (Index const &successor : mTasks[mOrder[i]].successors) {
+      if (--pending[successor] == 0) {
+        mOrder.push_back(successor);
+      }
+    }
+  }
+
+  if (mOrder.size() != mTasks.size()) {
+    TC_THROW("TaskGraph contains a cycle.");
+  }
+
+  mCounters = std::make_unique<Atomic<Ulong>[]>(mTasks.size());
+  mCallerTasks.reserve(mTasks.size());
+  mRun = 0;
+  mCompiled = true;
+}
+
+void TaskGraph::Execute(JobSystem &system) {
+  if (!mCompiled) {
+    this->Compile();
+  }
+
+  if (mTasks.empty()) {
+    return;
+  }
+
+  mSystem = &system;
+  mRun++;
+  mException = nullptr;
+  mCallerTasks.clear();
+  mCallerHead = 0;
+  mRemaining.store(mTasks.size());
+  mRunStart = std::chrono::steady_clock::now();
+
+  for (Index const &root : mRoots) {
+    this->Dispatch(root);
+  }
+
+  UniqueLock<Mutex> lock(mCallerLock);
+  while (mRemaining.load() > 0) {
+    mCallerCondition.wait(lock, [this] {
+      return mCallerHead < mCallerTasks.size() || mRemaining.load() == 0;
+    });
+
+    while (mCallerHead < mCallerTasks.size()) {
+      Index const index = mCallerTasks[mCallerHead++];
+      lock.unlock();
+      this->RunTask(index);
+      lock.lock();
+    }
+  }
+  lock.unlock();
+  mRunDuration = this->Now();
+
+  // Workers touch a node for a short moment after its task has finished.
+  for (Task const &task : mTasks) {
+    while (task.affinity == TaskAffinity::ANY && !task.node->IsFinished()) {
+      std::this_thread::yield();
+    }
+  }
+
+  if (mException) {
+    std::rethrow_exception(mException);
+  }
+}
+} // namespace Job
+} // namespace TerreateCore
@@ -0,0 +1,59 @@
+#include "../includes/input.hpp"
+
+#include <bit>
+#include <chrono>
+
+namespace TerreateCore {
+namespace Core {
+using namespace TerreateCore::Defines;
+
+InputSnapshotPin InputSnapshotRing::Get() const {
+  Ulong const current =
+      mCurrent.fetch_add(sSlotMask + 1, std::memory_order_acquire);
+  Index const slot = current & sSlotMask;
+  return InputSnapshotPin(&mSlots[slot], &mReaders[slot]);
+}
+
+Bool InputSnapshotRing::Publish(InputSnapshot const &snapshot) {
+  Index const current = mCurrent.load(std::memory_order_relaxed) & sSlotMask;
+  for (Index i = 1; i < sNumSlots; ++i) {
+    Index const slot = (current + i) % sNumSlots;
+    if (mReaders[slot].load(std::memory_order_acquire) != 0) {
+      continue;
+    }
+
+    mSlots[slot] = snapshot;
+    Ulong const retired = mCurrent.exchange(slot, std::memory_order_acq_rel);
+    // Pins released before this add wrap below zero and come back here.
+    mReaders[current].fetch_add(retired >> sSlotBits,
+                                std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+InputRing::InputRing(Size const &capacity) {
+  if (capacity == 0) {
+    TC_THROW("Input ring capacity must be positive.");
+  }
+  mEvents.resize(std::bit_ceil(capacity));
+  mMask = mEvents.size() - 1;
+}
+
+Bool InputRing::Next(Ulong &cursor, InputEvent &event) const {
+  if (cursor < this->GetBegin()) {
+    cursor = this->GetBegin();
+  }
+  if (cursor >= mEnd) {
+    return false;
+  }
+  event = mEvents[cursor++ & mMask];
+  return true;
+}
+
+Ulong InputRing::GetTimestamp() {
+  auto const now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+} // namespace Core
+} // namespace TerreateCore
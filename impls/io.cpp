@@ -0,0 +1,181 @@
+#include "../includes/io.hpp"
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Defines;
+
+void IOSystem::SpawnThread() {
+  Thread thread([this]() { this->IOThread(); });
+  Thread::id const id = thread.get_id();
+  mThreads.emplace(id, std::move(thread));
+}
+
+void IOSystem::JoinRetired() {
+  Vec<Thread> retired;
+  {
+    LockGuard<Mutex> lock(mLock);
+    retired.swap(mRetired);
+  }
+
+  for (Thread &thread : retired) {
+    thread.join();
+  }
+}
+
+void IOSystem::IOThread() {
+  auto const idleTime =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<Double>(mSettings.idleTime));
+  UniqueLock<Mutex> lock(mLock);
+  while (true) {
+    if (mRequests.empty()) {
+      if (mStop) {
+        break;
+      }
+
+      ++mNumIdle;
+      Bool const woken = mCondition.wait_for(
+          lock, idleTime, [this] { return mStop || !mRequests.empty(); });
+      --mNumIdle;
+      if (!woken && mThreads.size() > mSettings.minThreads) {
+        break;
+      }
+      continue;
+    }
+
+    JobBase *job = mRequests.front();
+    mRequests.pop();
+    lock.unlock();
+
+    Bool const adopted = job->mAdopted;
+    if (job->IsCancelled() || job->IsExpired()) {
+      job->Skip();
+    } else {
+      job->Run();
+    }
+    if (adopted) {
+      delete job;
+    }
+
+    lock.lock();
+  }
+
+  // A thread cannot join itself, so the next caller joins it.
+  auto it = mThreads.find(std::this_thread::get_id());
+  if (it != mThreads.end()) {
+    mRetired.push_back(std::move(it->second));
+    mThreads.erase(it);
+  }
+}
+
+IOSystem::IOSystem(IOSystemSettings const &settings) : mSettings(settings) {
+  if (mSettings.maxThreads == 0) {
+    TC_THROW("IOSystem needs at least one thread.");
+  }
+
+  LockGuard<Mutex> lock(mLock);
+  for (Uint i = 0; i < mSettings.minThreads; ++i) {
+    this->SpawnThread();
+  }
+}
+
+IOSystem::~IOSystem() { this->Stop(); }
+
+Uint IOSystem::GetNumThreads() {
+  LockGuard<Mutex> lock(mLock);
+  return mThreads.size();
+}
+
+Size IOSystem::GetNumRequests() {
+  LockGuard<Mutex> lock(mLock);
+  return mRequests.size();
+}
+
+void IOSystem::Stop() {
+  Vec<JobBase *> pending;
+  Vec<Thread> threads;
+  {
+    LockGuard<Mutex> lock(mLock);
+    mStop = true;
+    while (!mRequests.empty()) {
+      pending.push_back(mRequests.front());
+      mRequests.pop();
+    }
+    for (auto &[id, thread] : mThreads) {
+      threads.push_back(std::move(thread));
+    }
+    mThreads.clear();
+  }
+  mCondition.notify_all();
+
+  for (JobBase *job : pending) {
+    Bool const adopted = job->mAdopted;
+    job->Skip();
+    if (adopted) {
+      delete job;
+    }
+  }
+
+  for (Thread &thread : threads) {
+    thread.join();
+  }
+  this->JoinRetired();
+}
+
+void IOSystem::Adopt(JobBase *job) {
+  job->mAdopted = true;
+  job->mFinished = false;
+  job->mCounter = nullptr;
+  this->JoinRetired();
+
+  Bool queued = false;
+  {
+    LockGuard<Mutex> lock(mLock);
+    if (!mStop) {
+      mRequests.push(job);
+      queued = true;
+      // Every thread may be blocked on the disk, so grow instead of waiting
+      // once no idle thread is left for this request.
+      if (mNumIdle < mRequests.size() &&
+          mThreads.size() < mSettings.maxThreads) {
+        this->SpawnThread();
+      }
+    }
+  }
+
+  if (!queued) {
+    job->Skip();
+    delete job;
+    return;
+  }
+  // Idle threads must not sleep through the idle time while work waits.
+  mCondition.notify_one();
+}
+
+Future<Vec<Ubyte>> IOSystem::Read(Str const &path) {
+  return this->Submit([path]() { return IOSystem::ReadFile(path); });
+}
+
+Future<Str> IOSystem::ReadText(Str const &path) {
+  return this->Submit([path]() {
+    Vec<Ubyte> const data = IOSystem::ReadFile(path);
+    return Str(data.begin(), data.end());
+  });
+}
+
+Vec<Ubyte> IOSystem::ReadFile(Str const &path) {
+  InputFileStream file(path.c_str(), std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    TC_THROW("Failed to open file.");
+  }
+
+  Size const size = file.tellg();
+  Vec<Ubyte> data(size);
+  file.seekg(0, std::ios::beg);
+  if (!file.read((char *)data.data(), size)) {
+    TC_THROW("Failed to read file.");
+  }
+  return data;
+}
+} // namespace Job
+} // namespace TerreateCore
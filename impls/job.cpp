@@ -1,18 +1,64 @@
 #include "../includes/job.hpp"
+#include "../includes/topology.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||          \
+    defined(_M_IX86)
+#include <immintrin.h>
+#endif
 
 namespace TerreateCore {
 namespace Job {
 using namespace TerreateCore::Defines;
 
+namespace {
+thread_local void const *tWorkerSystem = nullptr;
+thread_local Uint tWorkerID = 0;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||          \
+    defined(_M_IX86)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+#endif
+}
+} // namespace
+
 void JobBase::Run() {
+  mSkipped = false;
+  mException = nullptr;
   try {
     this->Execute();
   } catch (...) {
     mException = std::current_exception();
   }
+  this->OnFinished(mException);
   mFinished = true;
 }
 
+void JobBase::Skip() {
+  mSkipped = true;
+  mException = std::make_exception_ptr(
+      Exception::CoreException("Job was cancelled before execution."));
+  this->OnFinished(mException);
+  mFinished = true;
+}
+
+void JobBase::SetTimeout(Double const &timeout) {
+  mDeadline = std::chrono::steady_clock::now() +
+              std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<Double>(timeout));
+}
+
+void JobBase::Rethrow() const {
+  if (mException) {
+    std::rethrow_exception(mException);
+  }
+}
+
 bool JobBase::IsExecutable() const {
   for (auto &dep : mDependencies) {
     if (!dep->IsFinished()) {
@@ -27,35 +73,191 @@ SimpleJob &SimpleJob::operator=(Function<void()> const &target) {
   return *this;
 }
 
-void JobSystem::WorkerThread() {
-  while (!mStop) {
-    JobBase *job = nullptr;
-    {
-      UniqueLock<Mutex> lock(mJobLock);
-      mCondition.wait(lock, [this] { return !mJobs.empty() || mStop; });
+void JobSystem::RunJob(JobBase *job, Uint const &thread) {
+  if (job->IsCancelled() || job->IsExpired()) {
+    this->SkipJob(job);
+    return;
+  }
 
-      if (mJobs.empty()) {
-        return;
-      }
+  Bool const adopted = job->mAdopted;
+  JobCounter *counter = job->mCounter;
+  if (!mTracer.IsEnabled() || thread == sUntraced) {
+    job->Run();
+  } else {
+    TraceEvent event;
+    event.type = TraceEventType::JOB;
+    event.start = mTracer.Now();
+    event.queueWait = event.start > job->mScheduledAt
+                          ? event.start - job->mScheduledAt
+                          : 0;
+    std::strncpy(event.name, job->mName.c_str(), sizeof(event.name) - 1);
+    job->Run();
+    event.end = mTracer.Now();
+    mTracer.Record(thread, event);
+  }
 
-      while (true) {
-        job = std::move(mJobs.front());
-        mJobs.pop();
+  if (adopted) {
+    delete job;
+  }
+
+  if (counter != nullptr) {
+    counter->Done();
+  }
+  this->NotifyProgress();
+}
+
+Uint JobSystem::GetTraceThread() const {
+  return tWorkerSystem == this ? tWorkerID : sUntraced;
+}
+
+void JobSystem::SkipJob(JobBase *job) {
+  Bool const adopted = job->mAdopted;
+  JobCounter *counter = job->mCounter;
+  job->Skip();
+  if (adopted) {
+    delete job;
+  }
+
+  if (counter != nullptr) {
+    counter->Done();
+  }
+  this->NotifyProgress();
+}
 
-        if (job->IsExecutable()) {
-          break;
-        } else {
-          mJobs.push(job);
-        }
+void JobSystem::NotifyProgress() {
+  mProgress.fetch_add(1);
+  // Only workers parked on blocked jobs need waking. Taking the lock orders
+  // the notification after their predicate check.
+  if (mNumParked.load() > 0 &&
+      mNumQueued.load(std::memory_order_relaxed) > 0) {
+    { LockGuard<Mutex> lock(mJobLock); }
+    mCondition.notify_all();
+  }
+}
+
+void JobSystem::FinishJobs(Uint const &count) {
+  if (mNumJobs.fetch_sub(count) == count) {
+    mComplete.store(true);
+    mComplete.notify_all();
+  }
+}
+
+void JobSystem::DropCancelled(Queue<JobBase *> &jobs,
+                              Vec<JobBase *> &dropped) {
+  Size const count = jobs.size();
+  for (Size i = 0; i < count; ++i) {
+    JobBase *job = jobs.front();
+    jobs.pop();
+    if (job->IsCancelled()) {
+      dropped.push_back(job);
+    } else {
+      jobs.push(job);
+    }
+  }
+}
+
+JobBase *JobSystem::AcquireJob(Uint const &thread) {
+  Bool const tracing = mTracer.IsEnabled() && thread != sUntraced;
+  Ulong const lockStart = tracing ? mTracer.Now() : 0;
+  UniqueLock<Mutex> lock(mJobLock);
+  if (tracing) {
+    Ulong const lockEnd = mTracer.Now();
+    if (lockEnd - lockStart >= sLockWaitThreshold) {
+      mTracer.Record(thread, {TraceEventType::LOCK_WAIT, lockStart, lockEnd});
+    }
+  }
+
+  // Each queued job is looked at once, so the lock is never held while
+  // waiting for dependencies to finish.
+  Ulong requeueStart = 0;
+  JobBase *job = nullptr;
+  for (Size i = mJobs.size(); i > 0; --i) {
+    JobBase *candidate = mJobs.front();
+    mJobs.pop();
+
+    if (candidate->IsExecutable()) {
+      job = candidate;
+      mNumQueued.fetch_sub(1, std::memory_order_relaxed);
+      break;
+    }
+
+    mJobs.push(candidate);
+    if (tracing && requeueStart == 0) {
+      requeueStart = mTracer.Now();
+    }
+  }
+
+  if (requeueStart != 0) {
+    mTracer.Record(thread,
+                   {TraceEventType::REQUEUE, requeueStart, mTracer.Now()});
+  }
+  return job;
+}
+
+void JobSystem::Idle(Uint const &thread, Uint &spins, Ulong const &progress) {
+  Bool const tracing = mTracer.IsEnabled();
+  Ulong const idleStart = tracing ? mTracer.Now() : 0;
+  Bool parked = false;
+
+  // Queued jobs whose dependencies are unfinished are not work. Only a new
+  // job or a finished one can make a job runnable.
+  auto const progressed = [this, &progress] {
+    return mProgress.load() != progress || mStop;
+  };
+
+  Bool found = false;
+  for (Uint i = 0; i < spins && !found; ++i) {
+    found = progressed();
+    CpuRelax();
+  }
+
+  for (Uint i = 0; i < mIdlePolicy.yields && !found; ++i) {
+    std::this_thread::yield();
+    found = progressed();
+  }
+
+  if (!found) {
+    UniqueLock<Mutex> lock(mJobLock);
+    mNumParked++;
+    if (!progressed()) {
+      parked = true;
+      if (mJobs.empty()) {
+        mCondition.wait(lock, progressed);
+      } else {
+        mCondition.wait_for(lock, sBlockedPoll, progressed);
       }
     }
+    mNumParked--;
+  }
 
-    job->Run();
+  // Spin longer while jobs keep arriving, and less once the queue goes quiet.
+  if (mIdlePolicy.adaptive) {
+    if (parked) {
+      spins = std::max(mIdlePolicy.minSpins, spins / 2);
+    } else {
+      spins = std::min(mIdlePolicy.maxSpins, std::max(1u, spins) * 2);
+    }
+  }
+
+  if (tracing) {
+    mTracer.Record(thread, {TraceEventType::IDLE, idleStart, mTracer.Now()});
+  }
+}
 
-    if (mNumJobs.fetch_sub(1) == 1) {
-      mComplete.store(true);
-      mComplete.notify_all();
+void JobSystem::WorkerThread(Uint const &id) {
+  tWorkerSystem = this;
+  tWorkerID = id;
+  Uint spins = mIdlePolicy.maxSpins;
+  while (!mStop) {
+    Ulong const progress = mProgress.load();
+    JobBase *job = this->AcquireJob(id);
+    if (job == nullptr) {
+      this->Idle(id, spins, progress);
+      continue;
     }
+
+    this->RunJob(job, id);
+    this->FinishJobs(1);
   }
 }
 
@@ -65,34 +267,322 @@ void JobSystem::DaemonThread(JobBase *job) {
   }
 }
 
-JobSystem::JobSystem(Uint const &numThreads) {
+JobSystem::JobSystem(Uint const &numThreads, IdlePolicy const &idle)
+    : mIdlePolicy(idle) {
   for (Uint i = 0; i < numThreads; ++i) {
-    mWorkers.emplace_back(Thread([this] { this->WorkerThread(); }));
+    mWorkers.emplace_back(Thread([this, i] { this->WorkerThread(i); }));
   }
 }
 
+JobSystem::JobSystem(JobSystemSettings const &settings)
+    : mIdlePolicy(settings.idle) {
+  Vec<Uint> cpus = settings.cpus;
+  Bool const restricted = !cpus.empty() || !settings.reservedCpus.empty();
+  if (cpus.empty() && (restricted || settings.pinWorkers)) {
+    cpus = CpuTopology().GetCpuIDs();
+  }
+
+  std::erase_if(cpus, [&settings](Uint const &cpu) {
+    auto const &reserved = settings.reservedCpus;
+    return std::find(reserved.begin(), reserved.end(), cpu) != reserved.end();
+  });
+
+  if (restricted && cpus.empty()) {
+    TC_THROW("No cpu is left for the JobSystem workers.");
+  }
+
+  Uint numThreads = settings.numThreads;
+  if (numThreads == 0) {
+    numThreads = cpus.empty() ? std::thread::hardware_concurrency()
+                              : (Uint)cpus.size();
+  }
+
+  for (Uint i = 0; i < numThreads; ++i) {
+    mWorkers.emplace_back(Thread([this, i] { this->WorkerThread(i); }));
+    if (settings.pinWorkers) {
+      CpuTopology::SetAffinity(mWorkers.back(), {cpus[i % cpus.size()]});
+    } else if (restricted) {
+      CpuTopology::SetAffinity(mWorkers.back(), cpus);
+    }
+  }
+}
+
+void JobSystem::TimerThread() {
+  UniqueLock<Mutex> lock(mTimerLock);
+  while (!mStop) {
+    if (mTimers.empty()) {
+      mTimerCondition.wait(lock, [this] { return mStop || !mTimers.empty(); });
+      continue;
+    }
+
+    auto const now = std::chrono::steady_clock::now();
+    JobTimer timer = mTimers.top();
+    if (now < timer.due) {
+      mTimerCondition.wait_until(lock, timer.due);
+      continue;
+    }
+
+    mTimers.pop();
+    if (!mActiveTimers.contains(timer.id)) {
+      continue;
+    }
+
+    Bool const idle = !timer.fired || timer.job->IsFinished();
+    if (timer.period > std::chrono::steady_clock::duration::zero()) {
+      timer.due += timer.period;
+      if (timer.due < now) {
+        timer.due = now + timer.period;
+      }
+      timer.fired = true;
+      mTimers.push(timer);
+    } else {
+      mActiveTimers.erase(timer.id);
+    }
+
+    if (idle) {
+      lock.unlock();
+      this->Schedule(timer.job);
+      lock.lock();
+    }
+  }
+}
+
+ID JobSystem::AddTimer(JobBase *job,
+                       std::chrono::steady_clock::time_point const &due,
+                       std::chrono::steady_clock::duration const &period) {
+  ID id = 0;
+  {
+    LockGuard<Mutex> lock(mTimerLock);
+    if (!mTimerThread.joinable()) {
+      mTimerThread = Thread([this] { this->TimerThread(); });
+    }
+
+    id = mNextTimer++;
+    JobTimer timer;
+    timer.id = id;
+    timer.job = job;
+    timer.due = due;
+    timer.period = period;
+    mTimers.push(timer);
+    mActiveTimers.insert(id);
+  }
+
+  mTimerCondition.notify_one();
+  return id;
+}
+
 void JobSystem::Stop() {
-  mStop.store(true);
+  {
+    LockGuard<Mutex> jobLock(mJobLock);
+    LockGuard<Mutex> timerLock(mTimerLock);
+    mStop.store(true);
+  }
   mCondition.notify_all();
+  mTimerCondition.notify_all();
+
+  if (mTimerThread.joinable()) {
+    mTimerThread.join();
+  }
 
   for (auto &worker : mWorkers) {
-    worker.join();
+    if (worker.joinable()) {
+      worker.join();
+    }
   }
 
   for (auto &daemon : mDaemons) {
-    daemon.join();
+    if (daemon.joinable()) {
+      daemon.join();
+    }
   }
 }
 
-void JobSystem::Schedule(JobBase *job) {
+void JobSystem::Schedule(JobBase *job, JobCounter *counter) {
+  job->mFinished = false;
+  job->mCounter = counter;
+  if (counter != nullptr) {
+    counter->Add();
+  }
+  job->mScheduledAt = mTracer.IsEnabled() ? mTracer.Now() : 0;
+  Bool parked = false;
   {
     UniqueLock<Mutex> lock(mJobLock);
     mJobs.push(job);
+    mNumQueued.fetch_add(1, std::memory_order_relaxed);
+    mProgress.fetch_add(1);
     mNumJobs.fetch_add(1);
     mComplete.store(false);
+    parked = mNumParked > 0;
+  }
+
+  // Spinning workers see the job without being woken up.
+  if (parked) {
+    mCondition.notify_one();
+  }
+}
+
+Size JobSystem::Cancel(CancelToken &token) {
+  token.Cancel();
+
+  Vec<JobBase *> dropped;
+  {
+    LockGuard<Mutex> lock(mJobLock);
+    this->DropCancelled(mJobs, dropped);
+    mNumQueued.fetch_sub(dropped.size(), std::memory_order_relaxed);
+  }
+  Uint const numJobs = dropped.size();
+  {
+    LockGuard<Mutex> lock(mContextLock);
+    this->DropCancelled(mContextJobs, dropped);
+  }
+
+  // Skipping runs continuations which may schedule jobs, so no lock is held.
+  for (JobBase *job : dropped) {
+    this->SkipJob(job);
+  }
+
+  if (numJobs > 0) {
+    this->FinishJobs(numJobs);
+  }
+  return dropped.size();
+}
+
+ID JobSystem::ScheduleAfter(JobBase *job, Double const &delay) {
+  auto const duration =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<Double>(delay));
+  return this->AddTimer(job, std::chrono::steady_clock::now() + duration,
+                        std::chrono::steady_clock::duration::zero());
+}
+
+ID JobSystem::ScheduleAt(JobBase *job,
+                         std::chrono::steady_clock::time_point const &time) {
+  return this->AddTimer(job, time, std::chrono::steady_clock::duration::zero());
+}
+
+ID JobSystem::ScheduleEvery(JobBase *job, Double const &period) {
+  auto const duration =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<Double>(period));
+  if (duration <= std::chrono::steady_clock::duration::zero()) {
+    TC_THROW("Timer period must be positive.");
+  }
+  return this->AddTimer(job, std::chrono::steady_clock::now() + duration,
+                        duration);
+}
+
+Bool JobSystem::CancelTimer(ID const &timer) {
+  LockGuard<Mutex> lock(mTimerLock);
+  return mActiveTimers.erase(timer) > 0;
+}
+
+void JobSystem::Adopt(JobBase *job, JobCounter *counter) {
+  job->mAdopted = true;
+  this->Schedule(job, counter);
+}
+
+void JobSystem::Wait(JobCounter const &counter) {
+  Uint const thread = this->GetTraceThread();
+  while (true) {
+    Size const count = counter.GetCount();
+    if (count == 0) {
+      return;
+    }
+
+    JobBase *job = this->AcquireJob(thread);
+    if (job == nullptr) {
+      counter.WaitChange(count);
+      continue;
+    }
+
+    this->RunJob(job, thread);
+    this->FinishJobs(1);
+  }
+}
+
+void JobSystem::WaitForAll() {
+  Uint const thread = this->GetTraceThread();
+  while (!mComplete.load()) {
+    JobBase *job = this->AcquireJob(thread);
+    if (job == nullptr) {
+      mComplete.wait(false);
+      continue;
+    }
+
+    this->RunJob(job, thread);
+    this->FinishJobs(1);
+  }
+}
+
+void JobSystem::ScheduleOnContext(JobBase *job) {
+  job->mFinished = false;
+  job->mCounter = nullptr;
+  job->mScheduledAt = mTracer.IsEnabled() ? mTracer.Now() : 0;
+  LockGuard<Mutex> lock(mContextLock);
+  mContextJobs.push(job);
+}
+
+void JobSystem::AdoptOnContext(JobBase *job) {
+  job->mAdopted = true;
+  this->ScheduleOnContext(job);
+}
+
+Uint JobSystem::ProcessContextJobs(Double const &budget) {
+  auto const start = std::chrono::steady_clock::now();
+  auto const limit = std::chrono::duration<Double>(budget);
+  Uint executed = 0;
+  Size skipped = 0;
+
+  while (true) {
+    JobBase *job = nullptr;
+    {
+      LockGuard<Mutex> lock(mContextLock);
+      if (mContextJobs.empty() || skipped >= mContextJobs.size()) {
+        break;
+      }
+
+      job = mContextJobs.front();
+      mContextJobs.pop();
+      if (!job->IsExecutable()) {
+        mContextJobs.push(job);
+        skipped++;
+        continue;
+      }
+    }
+
+    this->RunJob(job, mWorkers.size());
+    executed++;
+    skipped = 0;
+
+    if (std::chrono::steady_clock::now() - start >= limit) {
+      break;
+    }
+  }
+  return executed;
+}
+
+Size JobSystem::GetNumContextJobs() {
+  LockGuard<Mutex> lock(mContextLock);
+  return mContextJobs.size();
+}
+
+void JobSystem::EnableTracing(Size const &capacity) {
+  Vec<Str> names;
+  for (Uint i = 0; i < mWorkers.size(); ++i) {
+    names.push_back("Worker " + std::to_string(i));
+  }
+  names.push_back("Context");
+  mTracer.Enable(names, capacity);
+}
+
+Bool JobSystem::ExportTrace(Str const &path) const {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    return false;
   }
 
-  mCondition.notify_one();
+  mTracer.ExportChromeTrace(file);
+  return file.good();
 }
 } // namespace Job
 } // namespace TerreateCore
@@ -0,0 +1,33 @@
+#include "../includes/metrics.hpp"
+
+#include <bit>
+
+namespace TerreateCore {
+namespace Event {
+using namespace TerreateCore::Defines;
+
+void LatencyHistogram::Record(Ulong const &sample) {
+  ++buckets[std::bit_width(sample) < 64 ? std::bit_width(sample) : 63];
+  ++count;
+  total += sample;
+  max = sample > max ? sample : max;
+}
+
+Ulong LatencyHistogram::GetPercentile(Double const &percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  Ulong const rank = (Ulong)(percentile * (count - 1)) + 1;
+  Ulong seen = 0;
+  for (Uint i = 0; i < 64; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      Ulong const bound = i == 0 ? 0 : ((Ulong)1 << i) - 1;
+      return bound < max ? bound : max;
+    }
+  }
+  return max;
+}
+} // namespace Event
+} // namespace TerreateCore
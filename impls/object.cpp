@@ -5,7 +5,8 @@
 namespace TerreateCore {
 namespace Core {
 using namespace TerreateCore::Defines;
-std::mt19937 UUID::sRandomEngine = std::mt19937(std::random_device()());
+thread_local std::mt19937 UUID::sRandomEngine =
+    std::mt19937(std::random_device()());
 
 void UUID::GenerateUUID() {
   auto time = std::chrono::system_clock::now();
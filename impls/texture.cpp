@@ -80,6 +80,25 @@ TextureData Texture::LoadTexture(Str const &path) {
   return texData;
 }
 
+TextureData Texture::DecodeTexture(Vec<Ubyte> const &encoded) {
+  TextureData texData;
+  stbi_set_flip_vertically_on_load_thread(true);
+  auto pixelData = stbi_load_from_memory(
+      encoded.data(), encoded.size(), (int *)&texData.width,
+      (int *)&texData.height, (int *)&texData.channels, 0);
+  stbi_set_flip_vertically_on_load_thread(false);
+
+  if (pixelData == nullptr) {
+    TC_THROW("Failed to decode texture.");
+    return texData;
+  }
+
+  texData.pixels = Vec<Ubyte>(
+      pixelData, pixelData + texData.width * texData.height * texData.channels);
+  stbi_image_free(pixelData);
+  return texData;
+}
+
 void CubeTexture::SetFilter(FilterType const &filter) {
   mFilter = filter;
   Bind();
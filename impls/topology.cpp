@@ -0,0 +1,255 @@
+#include "../includes/topology.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Defines;
+
+namespace {
+Str ReadLine(std::filesystem::path const &path) {
+  InputFileStream file(path);
+  Str line;
+  if (file.is_open()) {
+    std::getline(file, line);
+  }
+  return line;
+}
+
+Uint ReadUint(std::filesystem::path const &path, Uint const &fallback) {
+  Str line = ReadLine(path);
+  if (line.empty()) {
+    return fallback;
+  }
+  return std::stoul(line);
+}
+
+#if defined(__linux__)
+Bool ApplyAffinity(pthread_t const &thread, Vec<Uint> const &cpus) {
+  // A cpu_set_t holds CPU_SETSIZE cpus, so size the set for larger ids.
+  Uint count = 1;
+  for (Uint const &cpu : cpus) {
+    count = std::max(count, cpu + 1);
+  }
+  cpu_set_t *set = CPU_ALLOC(count);
+  if (set == nullptr) {
+    return false;
+  }
+
+  Size const size = CPU_ALLOC_SIZE(count);
+  CPU_ZERO_S(size, set);
+  for (Uint const &cpu : cpus) {
+    CPU_SET_S(cpu, size, set);
+  }
+  Bool const applied = pthread_setaffinity_np(thread, size, set) == 0;
+  CPU_FREE(set);
+  return applied;
+}
+#elif defined(_WIN32)
+Bool ApplyAffinity(HANDLE const &thread, Vec<Uint> const &cpus) {
+  DWORD_PTR mask = 0;
+  for (Uint const &cpu : cpus) {
+    if (cpu < sizeof(DWORD_PTR) * 8) {
+      mask |= (DWORD_PTR)1 << cpu;
+    }
+  }
+  return SetThreadAffinityMask(thread, mask) != 0;
+}
+#endif
+} // namespace
+
+void CpuTopology::LoadSysfs() {
+  std::filesystem::path const root = "/sys/devices/system/cpu";
+  Vec<Uint> online = ParseCpuList(ReadLine(root / "online"));
+  if (online.empty()) {
+    return;
+  }
+
+  Map<Uint, Uint> nodes;
+  std::filesystem::path const nodeRoot = "/sys/devices/system/node";
+  std::error_code error;
+  for (auto const &entry :
+       std::filesystem::directory_iterator(nodeRoot, error)) {
+    Str const name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0 || name.size() <= 4 ||
+        !std::isdigit(name[4])) {
+      continue;
+    }
+
+    Uint const node = std::stoul(name.substr(4));
+    for (Uint const &cpu : ParseCpuList(ReadLine(entry.path() / "cpulist"))) {
+      nodes[cpu] = node;
+    }
+  }
+
+  Set<Uint> performance;
+  Set<Uint> efficiency;
+  for (Uint const &cpu :
+       ParseCpuList(ReadLine("/sys/devices/cpu_core/cpus"))) {
+    performance.insert(cpu);
+  }
+  for (Uint const &cpu :
+       ParseCpuList(ReadLine("/sys/devices/cpu_atom/cpus"))) {
+    efficiency.insert(cpu);
+  }
+
+  Map<Uint, Uint> capacities;
+  Uint maxCapacity = 0;
+  for (Uint const &cpu : online) {
+    Str const dir = "cpu" + std::to_string(cpu);
+    Uint const capacity = ReadUint(root / dir / "cpu_capacity", 0);
+    capacities[cpu] = capacity;
+    maxCapacity = std::max(maxCapacity, capacity);
+  }
+
+  for (Uint const &cpu : online) {
+    Str const dir = "cpu" + std::to_string(cpu);
+    CpuInfo info;
+    info.id = cpu;
+    info.package = ReadUint(root / dir / "topology/physical_package_id", 0);
+    info.core = ReadUint(root / dir / "topology/core_id", cpu);
+    info.node = nodes.count(cpu) ? nodes[cpu] : 0;
+
+    if (performance.count(cpu)) {
+      info.type = CoreType::PERFORMANCE;
+    } else if (efficiency.count(cpu)) {
+      info.type = CoreType::EFFICIENCY;
+    } else if (capacities[cpu] != 0) {
+      info.type = capacities[cpu] == maxCapacity ? CoreType::PERFORMANCE
+                                                 : CoreType::EFFICIENCY;
+    }
+    mCpus.push_back(info);
+  }
+}
+
+CpuTopology::CpuTopology() {
+#if defined(__linux__)
+  this->LoadSysfs();
+#endif
+
+  if (mCpus.empty()) {
+    Uint const count = std::max(1u, std::thread::hardware_concurrency());
+    for (Uint i = 0; i < count; ++i) {
+      CpuInfo info;
+      info.id = i;
+      info.core = i;
+      mCpus.push_back(info);
+    }
+  }
+}
+
+Vec<Uint> CpuTopology::GetCpuIDs() const {
+  Vec<Uint> ids;
+  for (CpuInfo const &cpu : mCpus) {
+    ids.push_back(cpu.id);
+  }
+  return ids;
+}
+
+Vec<Uint> CpuTopology::GetCpuIDs(Uint const &node) const {
+  Vec<Uint> ids;
+  for (CpuInfo const &cpu : mCpus) {
+    if (cpu.node == node) {
+      ids.push_back(cpu.id);
+    }
+  }
+  return ids;
+}
+
+Vec<Uint> CpuTopology::GetCpuIDs(CoreType const &type) const {
+  Vec<Uint> ids;
+  for (CpuInfo const &cpu : mCpus) {
+    if (cpu.type == type) {
+      ids.push_back(cpu.id);
+    }
+  }
+  return ids;
+}
+
+Vec<Uint> CpuTopology::GetNodes() const {
+  Vec<Uint> nodes;
+  for (CpuInfo const &cpu : mCpus) {
+    if (std::find(nodes.begin(), nodes.end(), cpu.node) == nodes.end()) {
+      nodes.push_back(cpu.node);
+    }
+  }
+  std::sort(nodes.begin(), nodes.end());
+  return nodes;
+}
+
+Bool CpuTopology::IsHybrid() const {
+  return !this->GetCpuIDs(CoreType::PERFORMANCE).empty() &&
+         !this->GetCpuIDs(CoreType::EFFICIENCY).empty();
+}
+
+Vec<Vec<Uint>> CpuTopology::PartitionByNode() const {
+  Vec<Vec<Uint>> partitions;
+  for (Uint const &node : this->GetNodes()) {
+    partitions.push_back(this->GetCpuIDs(node));
+  }
+  return partitions;
+}
+
+Vec<Vec<Uint>> CpuTopology::PartitionByCoreType() const {
+  Vec<Vec<Uint>> partitions;
+  for (CoreType const &type :
+       {CoreType::PERFORMANCE, CoreType::EFFICIENCY, CoreType::UNKNOWN}) {
+    Vec<Uint> ids = this->GetCpuIDs(type);
+    if (!ids.empty()) {
+      partitions.push_back(ids);
+    }
+  }
+  return partitions;
+}
+
+Bool CpuTopology::SetAffinity(Thread &thread, Vec<Uint> const &cpus) {
+#if defined(__linux__) || defined(_WIN32)
+  return ApplyAffinity(thread.native_handle(), cpus);
+#else
+  return false;
+#endif
+}
+
+Bool CpuTopology::SetCurrentAffinity(Vec<Uint> const &cpus) {
+#if defined(__linux__)
+  return ApplyAffinity(pthread_self(), cpus);
+#elif defined(_WIN32)
+  return ApplyAffinity(GetCurrentThread(), cpus);
+#else
+  return false;
+#endif
+}
+
+Vec<Uint> CpuTopology::ParseCpuList(Str const &list) {
+  Vec<Uint> cpus;
+  Stream stream(list);
+  Str range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty() || !std::isdigit(range[0])) {
+      continue;
+    }
+
+    Size const dash = range.find('-');
+    Uint const first = std::stoul(range.substr(0, dash));
+    Uint const last =
+        dash == Str::npos ? first : std::stoul(range.substr(dash + 1));
+    for (Uint cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+} // namespace Job
+} // namespace TerreateCore
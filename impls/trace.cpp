@@ -0,0 +1,108 @@
+#include "../includes/trace.hpp"
+
+#include <algorithm>
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Defines;
+
+namespace {
+char const *GetTraceEventName(TraceEvent const &event) {
+  switch (event.type) {
+  case TraceEventType::JOB:
+    return event.name[0] != '\0' ? event.name : "Job";
+  case TraceEventType::LOCK_WAIT:
+    return "LockWait";
+  case TraceEventType::IDLE:
+    return "Idle";
+  case TraceEventType::REQUEUE:
+    return "Requeue";
+  }
+  return "Unknown";
+}
+
+void WriteJsonString(std::ostream &stream, char const *text) {
+  stream << '"';
+  for (char const *c = text; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      stream << '\\';
+    }
+    stream << ((Ubyte)*c < 0x20 ? ' ' : *c);
+  }
+  stream << '"';
+}
+} // namespace
+
+TraceBuffer::TraceBuffer(Size const &capacity) {
+  Size size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  mEvents.resize(size);
+  mMask = size - 1;
+}
+
+Vec<TraceEvent> TraceBuffer::Collect() const {
+  Size const capacity = mEvents.size();
+  Ulong const head = mHead.load(std::memory_order_acquire);
+  Ulong const first = head > capacity ? head - capacity : 0;
+
+  Vec<TraceEvent> events;
+  events.reserve(head - first);
+  for (Ulong i = first; i < head; ++i) {
+    events.push_back(mEvents[i & mMask]);
+  }
+
+  // Drop the events the writer may have overwritten while copying.
+  Ulong const last = mHead.load(std::memory_order_acquire);
+  Ulong const valid = last > capacity ? last - capacity + 1 : 0;
+  if (valid > first) {
+    Size const dropped = std::min<Size>(valid - first, events.size());
+    events.erase(events.begin(), events.begin() + dropped);
+  }
+  return events;
+}
+
+Ulong JobTracer::Now() const {
+  auto const elapsed = std::chrono::steady_clock::now() - mEpoch;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+void JobTracer::Enable(Vec<Str> const &threadNames, Size const &capacity) {
+  if (mBuffers.empty()) {
+    mThreadNames = threadNames;
+    for (Size i = 0; i < threadNames.size(); ++i) {
+      mBuffers.push_back(std::make_unique<TraceBuffer>(capacity));
+    }
+    mEpoch = std::chrono::steady_clock::now();
+  }
+  mEnabled.store(true, std::memory_order_release);
+}
+
+void JobTracer::ExportChromeTrace(std::ostream &stream) const {
+  stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  Bool first = true;
+  for (Uint thread = 0; thread < mBuffers.size(); ++thread) {
+    stream << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\","
+           << "\"pid\":0,\"tid\":" << thread << ",\"args\":{\"name\":";
+    WriteJsonString(stream, mThreadNames[thread].c_str());
+    stream << "}}";
+    first = false;
+
+    for (TraceEvent const &event : mBuffers[thread]->Collect()) {
+      stream << ",{\"name\":";
+      WriteJsonString(stream, GetTraceEventName(event));
+      stream << ",\"cat\":\"job\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread
+             << ",\"ts\":" << event.start / 1000.0
+             << ",\"dur\":" << (event.end - event.start) / 1000.0;
+      if (event.type == TraceEventType::JOB) {
+        stream << ",\"args\":{\"queueWait\":" << event.queueWait / 1000.0
+               << "}";
+      }
+      stream << "}";
+    }
+  }
+  stream << "]}";
+}
+} // namespace Job
+} // namespace TerreateCore
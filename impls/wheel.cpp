@@ -0,0 +1,125 @@
+#include "../includes/wheel.hpp"
+
+#include <algorithm>
+
+namespace TerreateCore {
+namespace Event {
+using namespace TerreateCore::Defines;
+
+void TimerWheel::Link(Index const &entry) {
+  Entry &timer = mEntries[entry];
+  Ulong const difference = timer.due ^ mTick;
+  Uint level = 0;
+  while (level + 1 < sNumLevels &&
+         (difference >> (sLevelBits * (level + 1))) != 0) {
+    ++level;
+  }
+
+  Index const slot = level * sSlotsPerLevel +
+                     ((timer.due >> (sLevelBits * level)) &
+                      (sSlotsPerLevel - 1));
+  timer.slot = slot;
+  timer.prev = sNone;
+  timer.next = mSlots[slot];
+  if (timer.next != sNone) {
+    mEntries[timer.next].prev = entry;
+  }
+  mSlots[slot] = entry;
+}
+
+void TimerWheel::Unlink(Index const &entry) {
+  Entry &timer = mEntries[entry];
+  if (timer.prev != sNone) {
+    mEntries[timer.prev].next = timer.next;
+  } else {
+    mSlots[timer.slot] = timer.next;
+  }
+  if (timer.next != sNone) {
+    mEntries[timer.next].prev = timer.prev;
+  }
+}
+
+void TimerWheel::Cascade(Uint const &level) {
+  Index const slot =
+      level * sSlotsPerLevel +
+      ((mTick >> (sLevelBits * level)) & (sSlotsPerLevel - 1));
+  Index entry = mSlots[slot];
+  mSlots[slot] = sNone;
+  while (entry != sNone) {
+    Index const next = mEntries[entry].next;
+    this->Link(entry);
+    entry = next;
+  }
+}
+
+Ulong TimerWheel::Add(Ulong const &due, EventID const &event) {
+  Index entry = 0;
+  if (mFree.empty()) {
+    entry = mEntries.size();
+    mEntries.emplace_back();
+  } else {
+    entry = mFree.back();
+    mFree.pop_back();
+  }
+
+  Ulong const horizon = (Ulong)1 << (sLevelBits * sNumLevels);
+  Entry &timer = mEntries[entry];
+  timer.due = std::min(std::max(due, mTick + 1), mTick + horizon - 1);
+  timer.event = event;
+  timer.active = true;
+  this->Link(entry);
+  ++mSize;
+  return ((Ulong)timer.generation << 32) | entry;
+}
+
+Bool TimerWheel::Cancel(Ulong const &timer) {
+  Index const entry = timer & 0xFFFFFFFF;
+  if (entry >= mEntries.size() || !mEntries[entry].active ||
+      mEntries[entry].generation != (timer >> 32)) {
+    return false;
+  }
+
+  this->Unlink(entry);
+  mEntries[entry].active = false;
+  ++mEntries[entry].generation;
+  mFree.push_back(entry);
+  --mSize;
+  return true;
+}
+
+void TimerWheel::Advance(Ulong const &tick, Vec<EventID> &fired) {
+  while (mTick < tick) {
+    if (mSize == 0) {
+      mTick = tick;
+      return;
+    }
+
+    ++mTick;
+    // Upper levels are cascaded when the lower level wraps around.
+    Uint levels = 1;
+    while (levels < sNumLevels &&
+           ((mTick >> (sLevelBits * levels - sLevelBits)) &
+            (sSlotsPerLevel - 1)) == 0) {
+      ++levels;
+    }
+    for (Uint level = levels - 1; level > 0; --level) {
+      this->Cascade(level);
+    }
+
+    Index const slot = mTick & (sSlotsPerLevel - 1);
+    Index entry = mSlots[slot];
+    mSlots[slot] = sNone;
+    while (entry != sNone) {
+      Entry &timer = mEntries[entry];
+      Index const next = timer.next;
+      fired.push_back(timer.event);
+      timer.active = false;
+      ++timer.generation;
+      mFree.push_back(entry);
+      --mSize;
+      entry = next;
+    }
+  }
+}
+} // namespace Event
+} // namespace TerreateCore
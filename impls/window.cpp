@@ -92,6 +92,16 @@ void WindowContentScaleCallbackWrapper(GLFWwindow *window, float xscale,
 void MousebuttonCallbackWrapper(GLFWwindow *window, int button, int action,
                                 int mods) {
   Window *ptr = (Window *)glfwGetWindowUserPointer(window);
+  InputEvent event;
+  event.time = InputRing::GetTimestamp();
+  event.type = InputEventType::BUTTON;
+  event.action = action;
+  event.mods = mods;
+  event.code = button;
+  ptr->mProperty.mInputs.Push(event);
+  if (button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST) {
+    ptr->mProperty.mLiveInput.buttons[button] = action != GLFW_RELEASE;
+  }
   ptr->mController->MousebuttonCallback(button, action, Modifier(mods));
 }
 
@@ -99,6 +109,13 @@ void CursorPositionCallbackWrapper(GLFWwindow *window, double xpos,
                                    double ypos) {
   Window *ptr = (Window *)glfwGetWindowUserPointer(window);
   ptr->mProperty.mCursorPosition = Pair<double>(xpos, ypos);
+  InputEvent event;
+  event.time = InputRing::GetTimestamp();
+  event.type = InputEventType::CURSOR;
+  event.x = xpos;
+  event.y = ypos;
+  ptr->mProperty.mInputs.Push(event);
+  ptr->mProperty.mLiveInput.cursor = Pair<double>(xpos, ypos);
   ptr->mController->CursorPositionCallback(xpos, ypos);
 }
 
@@ -110,31 +127,65 @@ void CursorEnterCallbackWrapper(GLFWwindow *window, int entered) {
 void ScrollCallbackWrapper(GLFWwindow *window, double xoffset, double yoffset) {
   Window *ptr = (Window *)glfwGetWindowUserPointer(window);
   ptr->mProperty.mScrollOffset = Pair<double>(xoffset, yoffset);
+  InputEvent event;
+  event.time = InputRing::GetTimestamp();
+  event.type = InputEventType::SCROLL;
+  event.x = xoffset;
+  event.y = yoffset;
+  ptr->mProperty.mInputs.Push(event);
+  ptr->mProperty.mLiveInput.scroll.first += xoffset;
+  ptr->mProperty.mLiveInput.scroll.second += yoffset;
   ptr->mController->ScrollCallback(xoffset, yoffset);
 }
 
 void KeyCallbackWrapper(GLFWwindow *window, int key, int scancode, int action,
                         int mods) {
   Window *ptr = (Window *)glfwGetWindowUserPointer(window);
+  InputEvent event;
+  event.time = InputRing::GetTimestamp();
+  event.type = InputEventType::KEY;
+  event.action = action;
+  event.mods = mods;
+  event.code = key;
+  event.scancode = scancode;
+  ptr->mProperty.mInputs.Push(event);
   Key wrappedKey = Key(key, scancode, action, mods);
   ptr->mProperty.mKeys.push_back(wrappedKey);
+  if (key >= 0 && key <= GLFW_KEY_LAST) {
+    ptr->mProperty.mLiveInput.keys[key] = action != GLFW_RELEASE;
+  }
   ptr->mController->KeyCallback(wrappedKey);
 }
 
 void CharCallbackWrapper(GLFWwindow *window, Uint codepoint) {
   Window *ptr = (Window *)glfwGetWindowUserPointer(window);
+  InputEvent event;
+  event.time = InputRing::GetTimestamp();
+  event.type = InputEventType::CHAR;
+  event.code = codepoint;
+  ptr->mProperty.mInputs.Push(event);
   ptr->mProperty.mCodePoints.push_back(codepoint);
+  // Text beyond the fixed capacity stays available in the input ring.
+  InputSnapshot &live = ptr->mProperty.mLiveInput;
+  if (live.textLength < InputSnapshot::sMaxText) {
+    live.text[live.textLength++] = codepoint;
+  }
   ptr->mController->CharCallback(codepoint);
 }
 
 void DropCallbackWrapper(GLFWwindow *window, int count, const char **paths) {
   Window *ptr = (Window *)glfwGetWindowUserPointer(window);
-  Vec<Str> droppedFiles(paths, paths + count);
-  ptr->mProperty.mDroppedFiles = droppedFiles;
-  ptr->mController->DropCallback(droppedFiles);
+  ptr->mProperty.mDroppedFiles.assign(paths, paths + count);
+  ptr->mController->DropCallback(ptr->mProperty.mDroppedFiles);
 }
 } // namespace Callbacks
 
+void WindowProperty::ClearInputs() {
+  mCodePoints.clear();
+  mKeys.clear();
+  mDroppedFiles.clear();
+}
+
 Window::Window(Uint const &width, Uint const &height, Str const &title,
                WindowSettings const &settings) {
   glfwWindowHint(GLFW_RESIZABLE, settings.resizable);
@@ -189,16 +240,150 @@ void Window::SetTitle(Str const &title) {
 }
 
 void Window::Close() {
+  this->StopRenderThread();
   glfwDestroyWindow(mWindow);
   mWindow = nullptr;
 }
 
+Uint Window::ProcessContextJobs() {
+  if (mJobSystem == nullptr) {
+    return 0;
+  }
+
+  if (this->IsRenderThreaded()) {
+    // Only the render thread has the context current.
+    Job::JobSystem *system = mJobSystem;
+    Double const budget = mContextBudget;
+    this->Record([system, budget] { system->ProcessContextJobs(budget); });
+    return 0;
+  }
+  return mJobSystem->ProcessContextJobs(mContextBudget);
+}
+
+void Window::PollEvents() {
+  glfwPollEvents();
+
+  InputSnapshot &live = mProperty.mLiveInput;
+  ++live.frame;
+  live.time = InputRing::GetTimestamp();
+  if (!mInputSnapshots.Publish(live)) {
+    // Scroll and text carry over to the next snapshot.
+    --live.frame;
+    return;
+  }
+  live.scroll = Pair<double>(0.0, 0.0);
+  live.textLength = 0;
+}
+
+void Window::RenderThread() {
+  glfwMakeContextCurrent(mWindow);
+  while (true) {
+    {
+      UniqueLock<Mutex> lock(mRenderMutex);
+      mRenderCondition.wait(lock,
+                            [this] { return mPacketReady || mStopRender; });
+      if (!mPacketReady) {
+        break;
+      }
+      mPacketReady = false;
+      mRenderBusy = true;
+    }
+
+    // The main thread leaves the packet alone until mRenderBusy clears.
+    Job::JobSystem *system = mPacketJobSystem;
+    if (system != nullptr &&
+        mPacketQueuePoint == ContextQueuePoint::BEFORE_FRAME) {
+      system->ProcessContextJobs(mPacketBudget);
+    }
+    for (Function<void()> const &command : mRenderPacket) {
+      command();
+    }
+    if (system != nullptr &&
+        mPacketQueuePoint == ContextQueuePoint::AFTER_FRAME) {
+      system->ProcessContextJobs(mPacketBudget);
+    }
+    glfwSwapBuffers(mWindow);
+
+    {
+      LockGuard<Mutex> lock(mRenderMutex);
+      mRenderBusy = false;
+    }
+    mRenderCondition.notify_all();
+  }
+  glfwMakeContextCurrent(nullptr);
+}
+
+void Window::SubmitPacket() {
+  {
+    UniqueLock<Mutex> lock(mRenderMutex);
+    mRenderCondition.wait(lock,
+                          [this] { return !mPacketReady && !mRenderBusy; });
+    mRenderPacket.swap(mRecordPacket);
+    mPacketJobSystem = mJobSystem;
+    mPacketBudget = mContextBudget;
+    mPacketQueuePoint = mContextQueuePoint;
+    mPacketReady = true;
+  }
+  mRenderCondition.notify_all();
+  // Keeps the capacity for the next frame.
+  mRecordPacket.clear();
+}
+
+void Window::StartRenderThread() {
+  if (mWindow == nullptr || mRenderThread.joinable()) {
+    return;
+  }
+
+  glfwMakeContextCurrent(nullptr);
+  mStopRender = false;
+  mRenderThread = Thread(&Window::RenderThread, this);
+}
+
+void Window::StopRenderThread() {
+  if (!mRenderThread.joinable()) {
+    return;
+  }
+
+  {
+    LockGuard<Mutex> lock(mRenderMutex);
+    mStopRender = true;
+  }
+  mRenderCondition.notify_all();
+  mRenderThread.join();
+  mRecordPacket.clear();
+  mRenderPacket.clear();
+  glfwMakeContextCurrent(mWindow);
+}
+
+void Window::Record(Function<void()> command) {
+  if (!mRenderThread.joinable()) {
+    command();
+    return;
+  }
+  mRecordPacket.push_back(std::move(command));
+}
+
 void Window::Frame() {
   if (mWindow == nullptr) {
     return;
   }
 
+  if (mRenderThread.joinable()) {
+    // Context jobs run on the render thread.
+    mController->OnFrame(this);
+    this->SubmitPacket();
+    return;
+  }
+
+  if (mContextQueuePoint == ContextQueuePoint::BEFORE_FRAME) {
+    this->ProcessContextJobs();
+  }
+
   mController->OnFrame(this);
+
+  if (mContextQueuePoint == ContextQueuePoint::AFTER_FRAME) {
+    this->ProcessContextJobs();
+  }
 }
 } // namespace Core
 } // namespace TerreateCore
@@ -1,17 +1,25 @@
 #ifndef __TC_TERREATECORE_HPP__
 #define __TC_TERREATECORE_HPP__
 
+#include "arena.hpp"
 #include "buffer.hpp"
 #include "core.hpp"
 #include "defines.hpp"
 #include "event.hpp"
 #include "exceptions.hpp"
 #include "font.hpp"
+#include "graph.hpp"
+#include "input.hpp"
+#include "io.hpp"
 #include "job.hpp"
+#include "metrics.hpp"
 #include "object.hpp"
 #include "screen.hpp"
 #include "shader.hpp"
 #include "texture.hpp"
+#include "topology.hpp"
+#include "trace.hpp"
+#include "wheel.hpp"
 #include "window.hpp"
 
 #endif // __TC_TERREATECORE_HPP__
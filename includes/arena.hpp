@@ -0,0 +1,98 @@
+#ifndef __TC_ARENA_HPP__
+#define __TC_ARENA_HPP__
+
+#include <memory>
+#include <new>
+
+#include "defines.hpp"
+#include "object.hpp"
+
+namespace TerreateCore {
+namespace Core {
+using namespace TerreateCore::Defines;
+
+class FrameArena final : public Object {
+private:
+  struct Block {
+    std::unique_ptr<Ubyte[]> data;
+    Size size = 0;
+  };
+  struct Destructor {
+    void *object;
+    void (*destroy)(void *);
+  };
+
+private:
+  Vec<Block> mBlocks;
+  Vec<Destructor> mDestructors;
+  Size mBlockSize = 0;
+  Index mBlock = 0;
+  Size mOffset = 0;
+  Size mUsed = 0;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(FrameArena);
+
+public:
+  /*
+   * @brief: FrameArena is a bump allocator for objects living until the next
+   * Reset(). Memory blocks are kept across resets, so a steady workload
+   * stops allocating from the heap after the first frames.
+   * @param: blockSize: Size of a memory block in bytes.
+   */
+  FrameArena(Size const &blockSize = 64 * 1024) : mBlockSize(blockSize) {}
+  ~FrameArena() override { this->Reset(); }
+
+  /*
+   * @brief: Returns the number of bytes allocated since the last reset.
+   * @return: Allocated bytes.
+   */
+  Size GetUsed() const { return mUsed; }
+  /*
+   * @brief: Returns the number of bytes reserved from the heap.
+   * @return: Reserved bytes.
+   */
+  Size GetCapacity() const;
+
+  /*
+   * @brief: Allocate raw memory valid until the next reset.
+   * @param: size: Size in bytes.
+   * @param: alignment: Alignment in bytes. Must be a power of two.
+   * @return: Pointer to the memory.
+   */
+  void *Allocate(Size const &size, Size const &alignment);
+  /*
+   * @brief: Construct an object in the arena. Its destructor runs on reset.
+   * @param: args: Arguments forwarded to the constructor, or to aggregate
+   * initialization.
+   * @return: Pointer to the object.
+   */
+  template <typename T, typename... Args> T *Create(Args &&...args);
+  /*
+   * @brief: Destroy all objects and release all memory for reuse.
+   */
+  void Reset();
+
+  operator Bool() const override { return mBlockSize > 0; }
+};
+
+template <typename T, typename... Args>
+T *FrameArena::Create(Args &&...args) {
+  void *memory = this->Allocate(sizeof(T), alignof(T));
+  T *object = nullptr;
+  if constexpr (std::is_constructible_v<T, Args...>) {
+    object = new (memory) T(std::forward<Args>(args)...);
+  } else {
+    object = new (memory) T{std::forward<Args>(args)...};
+  }
+
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    mDestructors.push_back(
+        {object, [](void *target) { static_cast<T *>(target)->~T(); }});
+  }
+  return object;
+}
+} // namespace Core
+} // namespace TerreateCore
+
+#endif // __TC_ARENA_HPP__
@@ -1,6 +1,8 @@
 #ifndef __TC_CORE_HPP__
 #define __TC_CORE_HPP__
 
+#include <chrono>
+
 #include "defines.hpp"
 #include "object.hpp"
 
@@ -10,17 +12,121 @@ using namespace TerreateCore::Defines;
 extern Bool GLFW_INITIALIZED;
 extern Bool GLAD_INITIALIZED;
 
+struct FrameStats {
+public:
+  Ulong frames = 0;
+  Ulong missed = 0; // Frames whose work overran the target frame time.
+  Double last = 0.0;
+  Double min = 0.0;
+  Double max = 0.0;
+  Double mean = 0.0;
+  Double deviation = 0.0;
+  Double squares = 0.0; // Running sum of squared differences.
+};
+
 class Clock : public Object {
 private:
-  Float mLastTime = 0.0f;
-  Float mDeltaTime = 0.0f;
+  std::chrono::steady_clock::time_point mStart;
+  Ulong mLastTime = 0;
+  Ulong mDeltaTime = 0;
+  Ulong mFrameStart = 0;
+  Ulong mNextFrame = 0;
+  Ulong mPeriod = 0;
+  Ulong mSleepError = 0;
+  Ulong mSpinMargin = 1000000;
+  Ulong mFixedStep = 0;
+  Ulong mMaxAccumulated = 0;
+  Ulong mAccumulator = 0;
+  FrameStats mStats;
+
+private:
+  static constexpr Ulong sSecond = 1000000000;
+  // The spin margin never drops below this, since sleeps are never exact.
+  static constexpr Ulong sMinSpin = 100000;
+  static constexpr Ulong sMaxSpin = 20000000;
+
+private:
+  void WaitUntil(Ulong const &deadline);
+  void RecordFrame(Ulong const &now);
 
 public:
-  Clock() {}
-  ~Clock() {}
+  /*
+   * @brief: Clock measures time with the monotonic steady clock in
+   * nanoseconds, independent of GLFW.
+   * @detail: Frame() limits the frame rate by sleeping until shortly before
+   * the deadline and spinning for the rest. The spin margin adapts to the
+   * measured oversleep of the platform.
+   */
+  Clock() : mStart(std::chrono::steady_clock::now()) {}
+  ~Clock() override {}
+
+  /*
+   * @brief: Returns the time since the clock was created.
+   * @return: Time in nanoseconds.
+   */
+  Ulong GetTime() const;
+  /*
+   * @brief: Returns the time since the clock was created.
+   * @return: Time in seconds.
+   */
+  Double GetSeconds() const { return (Double)this->GetTime() / sSecond; }
+  /*
+   * @brief: Returns the time between the last two frames, or the interval
+   * measured by the last successful IsElapsed().
+   * @return: Time in seconds.
+   */
+  Double GetDeltaTime() const { return (Double)mDeltaTime / sSecond; }
+  /*
+   * @brief: Returns the frame time statistics since the last reset.
+   * @return: Statistics in seconds.
+   */
+  FrameStats const &GetStats() const { return mStats; }
+  /*
+   * @brief: Returns the fixed time step.
+   * @return: Time step in seconds.
+   */
+  Double GetFixedStep() const { return (Double)mFixedStep / sSecond; }
+  /*
+   * @brief: Returns how far the accumulated time is into the next fixed
+   * step, for interpolating between the last two simulation states.
+   * @return: Fraction between 0 and 1.
+   */
+  Double GetAlpha() const;
 
-  Bool IsElapsed(Float const &time);
+  /*
+   * @brief: Set the fixed time step. Frame() adds the frame time to an
+   * accumulator which ConsumeStep() drains one step at a time.
+   * @param: step: Time step in seconds.
+   * @param: maxAccumulated: Upper bound of the accumulated time in seconds,
+   * so a long stall does not trigger an endless catch-up.
+   */
+  void SetFixedStep(Double const &step, Double const &maxAccumulated = 0.25);
+  /*
+   * @brief: Take one fixed step from the accumulator.
+   * @return: true if a step should be simulated.
+   * @detail: Typical use is `while (clock.ConsumeStep()) Update(step);`
+   * after each Frame() call.
+   */
+  Bool ConsumeStep();
+  /*
+   * @brief: Reset the frame time statistics.
+   */
+  void ResetStats() { mStats = {}; }
 
+  /*
+   * @brief: Check whether the time has elapsed since the last check which
+   * returned true.
+   * @param: time: Time in seconds.
+   * @return: true if the time has elapsed.
+   */
+  Bool IsElapsed(Double const &time);
+  /*
+   * @brief: End a frame and wait until the target frame time has passed.
+   * @param: fps: Target frame rate. 0 disables the limit.
+   * @detail: Deadlines advance by a fixed period so the frame rate does not
+   * drift. After an overrun of a whole period the deadline restarts from
+   * the current time instead of rushing frames to catch up.
+   */
   void Frame(Uint const &fps);
 };
 
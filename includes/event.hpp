@@ -1,8 +1,16 @@
 #ifndef __TC_EVENT_HPP__
 #define __TC_EVENT_HPP__
 
+#include <chrono>
+#include <list>
+#include <typeinfo>
+
+#include "arena.hpp"
 #include "defines.hpp"
+#include "job.hpp"
+#include "metrics.hpp"
 #include "object.hpp"
+#include "wheel.hpp"
 
 namespace TerreateCore {
 namespace Event {
@@ -10,13 +18,235 @@ using namespace TerreateCore::Core;
 using namespace TerreateCore::Defines;
 
 using EventCallback = Function<void(Str const &)>;
+// Handlers receive the event name and the payload, nullptr if untyped.
+using EventHandler = Function<void(Str const &, void const *)>;
+using SubscriptionID = Ulong;
+
+// Use to declare whether a callback may run concurrently with others.
+enum class DispatchPolicy {
+  ORDERED,   // Runs on the thread calling ProcessEvents, in publish order.
+  CONCURRENT // Thread-safe, may run on a job worker during ProcessEvents.
+};
+
+// Handlers are stored contiguously and removed by swap-and-pop, so their
+// order within an event is not kept.
+struct HandlerList {
+public:
+  Vec<EventHandler> handlers;
+  Vec<Index> subscriptions;
+  Vec<Bool> removed; // Set while a removal is deferred.
+  Vec<HandlerMetrics> metrics;
+
+public:
+  static constexpr Index sNoMove = ~(Index)0;
+
+public:
+  Size GetSize() const { return handlers.size(); }
+  Index Add(EventHandler const &handler, Index const &subscription);
+  // Returns the subscription moved into the position, or sNoMove.
+  Index Remove(Index const &position);
+};
+
+struct EventSlot {
+  Str name;
+  HandlerList ordered;
+  HandlerList concurrent;
+  Queue<EventCallback> triggers;
+  Vec<void const *> pending; // Payloads of this frame for concurrent ones.
+};
+
+struct TopicNode {
+  Map<Str, Index> children;
+  Index star = ~(Index)0;
+  Index hash = ~(Index)0;
+  Vec<Index> patterns; // Patterns ending at this node.
+};
+
+struct PatternSlot {
+  Str pattern;
+  HandlerList handlers;
+};
+
+struct ResolvedTopic {
+  Ulong version = 0;
+  Vec<Index> patterns;
+};
+
+struct Subscription {
+  EventID event = 0; // Pattern index for wildcard subscriptions.
+  Index position = 0;
+  Uint generation = 0;
+  Bool concurrent = false;
+  Bool pattern = false;
+  Bool active = false;
+  Bool attached = false;
+};
+
+// Use to declare how events of a type published within a frame combine.
+// A payload type declares it as
+// `static constexpr CoalescePolicy sCoalescePolicy = ...;`.
+enum class CoalescePolicy {
+  NONE,   // Every event is delivered.
+  LATEST, // Only the latest payload of the frame is delivered.
+  MERGE   // Payloads are combined by `void Merge(E const &newer)`.
+};
+
+template <typename E>
+concept CoalescibleEvent = requires {
+  { E::sCoalescePolicy } -> std::convertible_to<CoalescePolicy>;
+};
+
+struct QueuedEvent {
+  EventID event;
+  void *payload;           // Lives in a frame arena, nullptr if untyped.
+  Ulong publishedAt = 0;   // Nanoseconds, 0 unless metrics or time
+                           // ordering are enabled.
+  // Shared queue events take odd values under the queue lock. Buffered
+  // events keep the even value they saw, which orders them after the
+  // earlier shared events of their thread.
+  Ulong sequence = 0;
+};
+
+struct PublishBuffer;
+
+// Buffers of one thread keyed by EventSystem instance. Owned by the thread,
+// so a buffer whose table expired belongs to a thread that has exited.
+struct ThreadBuffers {
+  Mutex mutex;
+  Map<Ulong, PublishBuffer *> buffers;
+};
+
+struct PublishBuffer {
+  std::weak_ptr<ThreadBuffers> owner;
+  Mutex mutex; // Only contended while ProcessEvents() merges the buffer.
+  Vec<QueuedEvent> events;
+  FrameArena arenas[2];
+  Index arenaIndex = 0;
+  Index frame = 1; // Arena released by the ProcessEvents() call.
+};
 
 class EventSystem : public Object {
 private:
-  Queue<Str> mEventQueue;
+  // Publishers append to mEventQueue while ProcessEvents dispatches
+  // mDispatchQueue. The two are swapped under the lock in O(1).
+  Vec<QueuedEvent> mEventQueue;
+  Vec<QueuedEvent> mDispatchQueue;
   Mutex mQueueMutex;
-  Map<Str, Vec<EventCallback>> mCallbacks;
-  Map<Str, Queue<EventCallback>> mTriggers;
+  // Guarded by mQueueMutex. Coalesced events map to their queue entry.
+  Vec<Index> mCoalescedEntries;
+  Vec<EventID> mCoalescedEvents;
+  FrameArena mArenas[2];
+  Index mArenaIndex = 0;
+  // Coalescing flags are read by publishers without a lock. Chunks are
+  // allocated under mQueueMutex and never move until destruction.
+  static constexpr Uint sFlagChunkBits = 10;
+  static constexpr Size sFlagChunkSize = (Size)1 << sFlagChunkBits;
+  static constexpr Size sNumFlagChunks = 1024;
+  Atomic<Atomic<Bool> *> mCoalesceFlags[sNumFlagChunks] = {};
+  // Other events are appended to a buffer owned by the publishing thread and
+  // merged by ProcessEvents(), so publishers do not share a lock.
+  // Buffers of exited threads are erased, so the others must not move.
+  std::list<PublishBuffer> mBuffers;
+  Mutex mBufferMutex;
+  Ulong const mInstance = EventSystem::NextInstance();
+  Atomic<Ulong> mSequence = 0;
+  Atomic<Bool> mTimeOrdered = false;
+  Map<Str, EventID> mEventIDs;
+  Vec<Str> mEventNames;
+  Vec<EventID> mTypeIDs;
+  Mutex mRegistryMutex;
+  static constexpr EventID sNoEvent = ~(EventID)0;
+  static constexpr Index sNoEntry = ~(Index)0;
+  // Deque keeps slots in place while callbacks register new events.
+  std::deque<EventSlot> mSlots;
+  Vec<EventID> mPendingSlots;
+  // Wildcard subscriptions are compiled into a trie over dotted segments.
+  Vec<TopicNode> mTopicNodes = Vec<TopicNode>(1);
+  std::deque<PatternSlot> mPatterns;
+  Map<Str, Index> mPatternIDs;
+  Vec<ResolvedTopic> mResolved;
+  Ulong mTopicVersion = 1;
+  Vec<Subscription> mSubscriptions;
+  Vec<Index> mFreeSubscriptions;
+  // Registrations and removals made by callbacks apply after dispatch.
+  Bool mDispatching = false;
+  Vec<std::pair<Index, EventHandler>> mDeferredAdds;
+  Vec<Index> mDeferredRemovals;
+  Atomic<Bool> mMetricsEnabled = false;
+  Vec<EventMetrics> mEventMetrics;
+  LatencyHistogram mQueueDepth;
+  Double mDumpInterval = 0.0;
+  Ulong mLastDump = 0;
+  Function<void(Str const &)> mDumpSink;
+  Job::JobSystem *mJobSystem = nullptr;
+  Job::JobCounter mDispatchCounter;
+  TimerWheel mTimers;
+  Mutex mTimerMutex;
+  Vec<EventID> mFiredTimers;
+  std::chrono::steady_clock::time_point mTimerEpoch =
+      std::chrono::steady_clock::now();
+  // Resolution of delayed events.
+  static constexpr std::chrono::milliseconds sTimerTick{1};
+
+private:
+  EventSlot &AcquireSlot(EventID const &event);
+  void DispatchConcurrent();
+  SubscriptionID Subscribe(EventID const &event, EventHandler const &handler,
+                           DispatchPolicy const &policy);
+  SubscriptionID AddSubscription(EventID const &target, Bool const &pattern,
+                                 EventHandler const &handler,
+                                 DispatchPolicy const &policy);
+  HandlerList &GetHandlerList(Subscription const &subscription);
+  Str const &GetSubscriptionName(Subscription const &subscription);
+  Index AcquirePattern(Str const &pattern);
+  void MatchTopic(Index const &node, Vec<Str> const &segments,
+                  Index const &depth, Vec<Index> &matches) const;
+  Vec<Index> const &ResolvePatterns(EventID const &event);
+  static Bool IsTopicPattern(Str const &event);
+  void RunOrdered(HandlerList &list, Str const &name, void const *payload,
+                  Bool const &metrics);
+  void Attach(Index const &subscription, EventHandler const &handler);
+  void Detach(Index const &subscription);
+  void ApplyDeferred();
+  HandlerMetrics *FindHandlerMetrics(Index const &subscription);
+  Ulong Stamp() const {
+    return mMetricsEnabled || mTimeOrdered ? GetTimestamp() : 0;
+  }
+  // Call with mQueueMutex held.
+  QueuedEvent MakeQueued(EventID const &event, void *payload) {
+    Ulong const sequence = mSequence.load(std::memory_order_relaxed);
+    mSequence.store(sequence + 2, std::memory_order_relaxed);
+    return {event, payload, this->Stamp(), sequence + 1};
+  }
+  QueuedEvent MakeBuffered(EventID const &event, void *payload) const {
+    return {event, payload, this->Stamp(),
+            mSequence.load(std::memory_order_relaxed)};
+  }
+  void CollectTimers();
+  void PushEvent(EventID const &event);
+  PublishBuffer &AcquireBuffer();
+  void MergeBuffers();
+  void ReleaseBuffers();
+  QueuedEvent *AcquireCoalesced(EventID const &event);
+  Bool IsCoalesced(EventID const &event) const;
+  Ulong ToTick(std::chrono::steady_clock::time_point const &time) const;
+  EventID GetTypeEventID(Index const &type, char const *name);
+
+private:
+  static Ulong GetTimestamp();
+  static Index NextTypeIndex();
+  static Ulong NextInstance();
+  template <typename E> static Index GetTypeIndex() {
+    static Index const index = EventSystem::NextTypeIndex();
+    return index;
+  }
+  template <typename E, typename... Args> static E MakeEvent(Args &&...args) {
+    if constexpr (std::is_constructible_v<E, Args...>) {
+      return E(std::forward<Args>(args)...);
+    } else {
+      return E{std::forward<Args>(args)...};
+    }
+  }
 
 public:
   /*
@@ -25,31 +255,309 @@ public:
    * to be published to the system.
    */
   EventSystem() {}
-  virtual ~EventSystem() override = default;
+  virtual ~EventSystem() override;
+
+  /*
+   * @brief: Set the JobSystem running concurrent callbacks. Without one,
+   * concurrent callbacks run on the thread calling ProcessEvents.
+   * @param: system: The JobSystem, or nullptr.
+   */
+  void SetJobSystem(Job::JobSystem *system) { mJobSystem = system; }
+
+  /*
+   * @brief: Enable recording of metrics. Metrics cost two clock reads per
+   * event and per handler call, and nothing while disabled.
+   * @param: dumpInterval: interval in seconds between metric reports passed
+   * to the dump sink, or 0 for no periodic report.
+   */
+  void EnableMetrics(Double const &dumpInterval = 0.0);
+  /*
+   * @brief: Disable recording of metrics. Recorded metrics are kept.
+   */
+  void DisableMetrics() { mMetricsEnabled = false; }
+  /*
+   * @brief: Clear all recorded metrics.
+   */
+  void ResetMetrics();
+  /*
+   * @brief: Set where periodic metric reports go. Defaults to std::clog.
+   * @param: sink: function receiving a report.
+   */
+  void SetMetricsSink(Function<void(Str const &)> const &sink) {
+    mDumpSink = sink;
+  }
+  /*
+   * @brief: Returns the metrics of an event.
+   * @param: event: the event id
+   * @return: metrics of the event
+   */
+  EventMetrics GetMetrics(EventID const &event) const;
+  /*
+   * @brief: Returns the metrics of a registered handler.
+   * @param: subscription: subscription id returned by Register()
+   * @return: metrics of the handler, empty if the id is stale
+   */
+  HandlerMetrics GetHandlerMetrics(SubscriptionID const &subscription);
+  /*
+   * @brief: Returns the queue depth seen by ProcessEvents() calls.
+   * @return: histogram of queue depths
+   */
+  LatencyHistogram const &GetQueueDepth() const { return mQueueDepth; }
+  /*
+   * @brief: Returns the number of per-thread publish buffers. This function
+   * is thread safe.
+   * @return: number of publish buffers
+   * @detail: Buffers of exited threads are dropped by ProcessEvents() once
+   * their events have been dispatched.
+   */
+  Size GetNumPublishBuffers() {
+    LockGuard<Mutex> lock(mBufferMutex);
+    return mBuffers.size();
+  }
+  /*
+   * @brief: Build a report of all metrics, listing handlers from the most
+   * expensive one.
+   * @return: report text
+   */
+  Str DumpMetrics();
+
+  /*
+   * @brief: Get the id of an event, registering the event if needed.
+   * This function is thread safe.
+   * @param: event: the event name
+   * @return: dense id of the event
+   */
+  EventID GetEventID(Str const &event);
+  /*
+   * @brief: Get the name of an event. This function is thread safe.
+   * @param: event: the event id
+   * @return: the event name
+   */
+  Str GetEventName(EventID const &event);
+  /*
+   * @brief: Get the id of a typed event, registering the event if needed.
+   * This function is thread safe.
+   * @tparam: E: the payload type of the event
+   * @return: dense id of the event
+   */
+  template <typename E> EventID GetEventID() {
+    return this->GetTypeEventID(GetTypeIndex<E>(), typeid(E).name());
+  }
 
   /*
    * @brief: Register a callback to an event
    * @param: event: the event to register to
    * @param: callback: the callback to register
+   * @param: policy: whether the callback may run on a job worker
+   * @return: subscription id which can be passed to Unregister()
+   */
+  SubscriptionID
+  Register(EventID const &event, EventCallback const &callback,
+           DispatchPolicy const &policy = DispatchPolicy::ORDERED) {
+    return this->Subscribe(
+        event, [callback](Str const &name, void const *) { callback(name); },
+        policy);
+  }
+  /*
+   * @brief: Register a callback to an event or to every event matching a
+   * dotted topic pattern. '*' matches one segment and '#' matches zero or
+   * more, so "net.player.*" matches "net.player.join" and "input.key.#"
+   * matches "input.key" and "input.key.down.a".
+   * @param: event: the event or topic pattern to register to
+   * @param: callback: the callback to register
+   * @param: policy: whether the callback may run on a job worker
+   * @return: subscription id which can be passed to Unregister()
+   * @detail: Matching patterns are resolved once per event and cached until
+   * a new pattern is added. Wildcard callbacks run in order after the
+   * callbacks of the concrete event and cannot be CONCURRENT.
+   */
+  SubscriptionID
+  Register(Str const &event, EventCallback const &callback,
+           DispatchPolicy const &policy = DispatchPolicy::ORDERED);
+  /*
+   * @brief: Register a listener to a typed event.
+   * @tparam: E: the payload type of the event
+   * @param: listener: the listener receiving the payload
+   * @param: policy: whether the listener may run on a job worker
+   * @return: subscription id which can be passed to Unregister()
+   */
+  template <typename E>
+  SubscriptionID
+  Register(Function<void(E const &)> const &listener,
+           DispatchPolicy const &policy = DispatchPolicy::ORDERED) {
+    return this->Subscribe(
+        this->GetEventID<E>(),
+        [listener](Str const &, void const *payload) {
+          if (payload != nullptr) {
+            listener(*static_cast<E const *>(payload));
+          }
+        },
+        policy);
+  }
+  /*
+   * @brief: Remove a callback or listener in O(1).
+   * @param: subscription: subscription id returned by Register()
+   * @return: true if the subscription was active
+   * @detail: Removing an ordered callback from within ProcessEvents() stops
+   * it at once. Concurrent ones may still receive the events of the frame
+   * being processed. Like Register(), call it from the thread calling
+   * ProcessEvents().
+   */
+  Bool Unregister(SubscriptionID const &subscription);
+  /*
+   * @brief: Set whether an untyped event is coalesced. A coalesced event is
+   * delivered at most once per ProcessEvents() call, however often it was
+   * published. This function is thread safe.
+   * @param: event: the event
+   * @param: coalesce: true to coalesce the event
+   */
+  void SetCoalescing(EventID const &event, Bool const &coalesce);
+  /*
+   * @brief: Set whether an untyped event is coalesced. This function is
+   * thread safe.
+   * @param: event: the event
+   * @param: coalesce: true to coalesce the event
+   */
+  void SetCoalescing(Str const &event, Bool const &coalesce) {
+    this->SetCoalescing(this->GetEventID(event), coalesce);
+  }
+  /*
+   * @brief: Set whether the events of a frame are dispatched in the order
+   * of their publication time. This function is thread safe.
+   * @param: ordered: true to sort events by their publication time
+   * @detail: By default the events of each thread are dispatched in
+   * publish order, and events of different threads are not ordered against
+   * each other. A coalesced event keeps the position of its first publish
+   * and a delayed event is ordered when it fires. Time ordering stamps
+   * every event with the steady clock instead.
+   */
+  void SetTimeOrdering(Bool const &ordered) { mTimeOrdered = ordered; }
+  /*
+   * @brief: Register a trigger to an event. A trigger is a callback
+   * that is only called once and then removed from the event.
+   * @param: event: the event to register to
+   * @param: callback: the callback to register
    */
-  void Register(Str const &event, EventCallback const &callback);
+  void AddTrigger(EventID const &event, EventCallback const &callback);
   /*
    * @brief: Register a trigger to an event. A trigger is a callback
    * that is only called once and then removed from the event.
    * @param: event: the event to register to
    * @param: callback: the callback to register
    */
-  void AddTrigger(Str const &event, EventCallback const &callback);
+  void AddTrigger(Str const &event, EventCallback const &callback) {
+    this->AddTrigger(this->GetEventID(event), callback);
+  }
 
   /*
-   * @brief: Process all events in the queue. This function is thread safe.
+   * @brief: Process all events in the queue. Other threads may publish
+   * while events are processed, but only one thread may process them.
+   * @detail: Callbacks run without any lock held. Events published by
+   * callbacks are processed by the next call. Each concurrent callback runs
+   * as one job receiving its events in publish order, while ordered
+   * callbacks run on the calling thread. The call returns once both are
+   * done.
    */
   void ProcessEvents();
   /*
    * @brief: Publish an event to the system. This function is thread safe.
    * @param: event: the event to publish
    */
-  void PublishEvent(Str const &event);
+  void PublishEvent(EventID const &event);
+  /*
+   * @brief: Publish an event to the system. This function is thread safe.
+   * @param: event: the event to publish
+   * @detail: Prefer the EventID overload on hot paths, which neither hashes
+   * nor allocates.
+   */
+  void PublishEvent(Str const &event) {
+    this->PublishEvent(this->GetEventID(event));
+  }
+  /*
+   * @brief: Publish an event after a delay. This function is thread safe.
+   * @param: event: the event to publish
+   * @param: delay: delay in seconds
+   * @return: timer id which can be passed to CancelTimer()
+   * @detail: Due events are published by the first ProcessEvents call after
+   * they are due, with millisecond resolution.
+   */
+  Ulong PublishAfter(EventID const &event, Double const &delay);
+  /*
+   * @brief: Publish an event after a delay. This function is thread safe.
+   * @param: event: the event to publish
+   * @param: delay: delay in seconds
+   * @return: timer id which can be passed to CancelTimer()
+   */
+  Ulong PublishAfter(Str const &event, Double const &delay) {
+    return this->PublishAfter(this->GetEventID(event), delay);
+  }
+  /*
+   * @brief: Publish an event at a point in time. This function is thread
+   * safe.
+   * @param: event: the event to publish
+   * @param: time: the time at which the event is due
+   * @return: timer id which can be passed to CancelTimer()
+   */
+  Ulong PublishAt(EventID const &event,
+                  std::chrono::steady_clock::time_point const &time);
+  /*
+   * @brief: Publish an event at a point in time. This function is thread
+   * safe.
+   * @param: event: the event to publish
+   * @param: time: the time at which the event is due
+   * @return: timer id which can be passed to CancelTimer()
+   */
+  Ulong PublishAt(Str const &event,
+                  std::chrono::steady_clock::time_point const &time) {
+    return this->PublishAt(this->GetEventID(event), time);
+  }
+  /*
+   * @brief: Cancel an event created by PublishAfter() or PublishAt() which
+   * is not due yet. This function is thread safe.
+   * @param: timer: timer id
+   * @return: true if the event was pending
+   */
+  Bool CancelTimer(Ulong const &timer);
+  /*
+   * @brief: Publish a typed event to the system. This function is thread
+   * safe.
+   * @tparam: E: the payload type of the event
+   * @param: args: arguments constructing the payload
+   * @detail: The payload is built in a frame arena and released after the
+   * ProcessEvents() call dispatching it, so listeners must not keep
+   * references to it. If E declares a CoalescePolicy, later events of the
+   * frame update the first queued payload instead of being queued.
+   */
+  template <typename E, typename... Args> void Publish(Args &&...args) {
+    EventID const event = this->GetEventID<E>();
+    if constexpr (CoalescibleEvent<E>) {
+      if constexpr (E::sCoalescePolicy != CoalescePolicy::NONE) {
+        // Coalesced events share one queue so one payload survives a frame.
+        LockGuard<Mutex> lock(mQueueMutex);
+        QueuedEvent *queued = this->AcquireCoalesced(event);
+        if (queued != nullptr) {
+          E *payload = static_cast<E *>(queued->payload);
+          if constexpr (E::sCoalescePolicy == CoalescePolicy::MERGE) {
+            payload->Merge(MakeEvent<E>(std::forward<Args>(args)...));
+          } else {
+            *payload = MakeEvent<E>(std::forward<Args>(args)...);
+          }
+          return;
+        }
+
+        E *payload =
+            mArenas[mArenaIndex].Create<E>(std::forward<Args>(args)...);
+        mEventQueue.push_back(this->MakeQueued(event, payload));
+        return;
+      }
+    }
+
+    PublishBuffer &buffer = this->AcquireBuffer();
+    LockGuard<Mutex> lock(buffer.mutex);
+    E *payload =
+        buffer.arenas[buffer.arenaIndex].Create<E>(std::forward<Args>(args)...);
+    buffer.events.push_back(this->MakeBuffered(event, payload));
+  }
 };
 } // namespace Event
 } // namespace TerreateCore
@@ -25,6 +25,7 @@ private:
   FT_Library mLibrary;
   FT_Face mFace;
   Uint mSize;
+  Vec<Ubyte> mData;
   Map<wchar_t, Shared<Character>> mCharacters;
 
 private:
@@ -37,6 +38,14 @@ public:
    * @param: size: size of font
    */
   Font(Str const &path, Uint const &size);
+  /*
+   * @brief: Constructor for RawFont from a font file in memory.
+   * @param: data: contents of font file
+   * @param: size: size of font
+   * @detail: Use with IOSystem::Read() to keep disk reads off the job
+   * workers. The font keeps the data alive for FreeType.
+   */
+  Font(Vec<Ubyte> &&data, Uint const &size);
   ~Font() override;
 
   /*
@@ -0,0 +1,160 @@
+#ifndef __TC_GRAPH_HPP__
+#define __TC_GRAPH_HPP__
+
+#include <chrono>
+
+#include "defines.hpp"
+#include "job.hpp"
+#include "object.hpp"
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Core;
+using namespace TerreateCore::Defines;
+
+// Use to select which thread executes a task of a TaskGraph.
+enum class TaskAffinity {
+  ANY,   // Any worker of the JobSystem.
+  CALLER // The thread calling TaskGraph::Execute().
+};
+
+struct TaskTiming {
+public:
+  Ulong start = 0; // Nanoseconds since the start of the run.
+  Ulong end = 0;   // Nanoseconds since the start of the run.
+
+public:
+  Ulong GetDuration() const { return end - start; }
+};
+
+class TaskGraph : public Object {
+private:
+  class TaskNode final : public JobBase {
+  private:
+    TaskGraph *mGraph = nullptr;
+    Index mIndex = 0;
+
+  public:
+    TaskNode(TaskGraph *graph, Index const &index)
+        : mGraph(graph), mIndex(index) {}
+    ~TaskNode() override = default;
+
+    void Execute() override { mGraph->RunTask(mIndex); }
+  };
+
+  struct Task {
+  public:
+    Str name;
+    Function<void()> function;
+    TaskAffinity affinity = TaskAffinity::ANY;
+    Vec<Index> successors;
+    Ulong numPredecessors = 0;
+    Shared<TaskNode> node;
+    TaskTiming timing;
+  };
+
+private:
+  Vec<Task> mTasks;
+  Vec<Index> mRoots;
+  Vec<Index> mOrder;
+  std::unique_ptr<Atomic<Ulong>[]> mCounters;
+  Bool mCompiled = false;
+  JobSystem *mSystem = nullptr;
+  Ulong mRun = 0;
+  Atomic<Size> mRemaining = 0;
+  std::chrono::steady_clock::time_point mRunStart;
+  Ulong mRunDuration = 0;
+  Mutex mCallerLock;
+  CondVar mCallerCondition;
+  Vec<Index> mCallerTasks;
+  Index mCallerHead = 0;
+  std::exception_ptr mException = nullptr;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(TaskGraph);
+
+private:
+  void Dispatch(Index const &index);
+  void RunTask(Index const &index);
+  Ulong Now() const;
+
+public:
+  /*
+   * @brief: TaskGraph is a set of tasks and dependencies between them which
+   * is built once and executed on a JobSystem as many times as needed.
+   * @detail: Executing the graph again doesn't allocate memory and doesn't
+   * resolve the dependencies again. Each task counts how many of its
+   * predecessors have finished, and the counters are never reset: a task of
+   * the n-th run becomes ready when its counter reaches n times its number of
+   * predecessors.
+   */
+  TaskGraph() {}
+  ~TaskGraph() override = default;
+
+  /*
+   * @brief: Returns the number of tasks in the graph.
+   * @return: Number of tasks.
+   */
+  Size GetSize() const { return mTasks.size(); }
+  /*
+   * @brief: Returns the name of a task.
+   * @param: task: Task index.
+   * @return: Task name.
+   */
+  Str const &GetName(Index const &task) const { return mTasks[task].name; }
+  /*
+   * @brief: Returns the timing of a task measured during the last run.
+   * @param: task: Task index.
+   * @return: Task timing.
+   */
+  TaskTiming const &GetTiming(Index const &task) const {
+    return mTasks[task].timing;
+  }
+  /*
+   * @brief: Returns the duration of the last run.
+   * @return: Duration in nanoseconds.
+   */
+  Ulong GetLastDuration() const { return mRunDuration; }
+  /*
+   * @brief: Returns the chain of dependent tasks with the longest total
+   * duration during the last run.
+   * @return: Task indices of the critical path, in execution order.
+   */
+  Vec<Index> GetCriticalPath() const;
+
+  /*
+   * @brief: Add a task to the graph.
+   * @param: name: Task name used for timings.
+   * @param: function: The function to be executed.
+   * @param: affinity: Which thread executes the task.
+   * @return: Index of the new task.
+   */
+  Index AddTask(Str const &name, Function<void()> const &function,
+                TaskAffinity const &affinity = TaskAffinity::ANY);
+  /*
+   * @brief: Add a dependency between two tasks.
+   * @param: before: The task that must be finished first.
+   * @param: after: The task that waits for "before".
+   */
+  void AddEdge(Index const &before, Index const &after);
+  /*
+   * @brief: Resolve the dependencies of the graph. This is called by
+   * Execute() if the graph has been modified since the last call.
+   * @detail: Throws if the graph contains a cycle.
+   */
+  void Compile();
+  /*
+   * @brief: Execute all tasks and block until they are finished. Tasks with
+   * TaskAffinity::CALLER are executed by the calling thread while it waits.
+   * @param: system: The JobSystem executing the tasks.
+   * @detail: If a task throws, its successors are still executed and the
+   * first exception is rethrown after the run.
+   */
+  void Execute(JobSystem &system);
+
+  operator Bool() const override { return mCompiled; }
+};
+} // namespace Job
+} // namespace TerreateCore
+
+#endif // __TC_GRAPH_HPP__
@@ -0,0 +1,240 @@
+#ifndef __TC_INPUT_HPP__
+#define __TC_INPUT_HPP__
+
+#include <bitset>
+
+#include "defines.hpp"
+#include "object.hpp"
+
+namespace TerreateCore {
+namespace Core {
+using namespace TerreateCore::Defines;
+
+// Use to identify the kind of an InputEvent.
+enum class InputEventType : Ubyte { KEY, CHAR, BUTTON, SCROLL, CURSOR };
+
+struct InputEvent {
+  Ulong time = 0; // Steady clock nanoseconds.
+  InputEventType type = InputEventType::KEY;
+  Ubyte action = 0; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT.
+  Ushort mods = 0;
+  Int code = 0; // Key, code point or mouse button.
+  Int scancode = 0;
+  Double x = 0.0; // Cursor position or scroll offset.
+  Double y = 0.0;
+};
+
+struct InputSnapshot {
+public:
+  static constexpr Size sMaxText = 32;
+
+public:
+  Ulong frame = 0; // Number of the publish producing this snapshot.
+  Ulong time = 0;  // Steady clock nanoseconds of the publish.
+  std::bitset<GLFW_KEY_LAST + 1> keys;
+  std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> buttons;
+  Pair<double> cursor = {0.0, 0.0};
+  Pair<double> scroll = {0.0, 0.0}; // Summed over the frame.
+  Uint text[sMaxText] = {};         // Code points typed during the frame.
+  Size textLength = 0;
+
+public:
+  /*
+   * @brief: Returns whether a key was held when the snapshot was taken.
+   * @param: key: Key.
+   * @return: Whether the key was held or not.
+   */
+  Bool IsPressing(Keyboard const &key) const {
+    Int const index = (Int)key;
+    return index >= 0 && index < (Int)keys.size() && keys[index];
+  }
+  /*
+   * @brief: Returns whether a mouse button was held when the snapshot was
+   * taken.
+   * @param: button: Mouse button.
+   * @return: Whether the button was held or not.
+   */
+  Bool GetMousebutton(MousebuttonInput const &button) const {
+    return buttons[(Uint)button];
+  }
+};
+
+class InputSnapshotPin final {
+private:
+  InputSnapshot const *mSnapshot = nullptr;
+  Atomic<Ulong> *mReaders = nullptr;
+
+private:
+  friend class InputSnapshotRing;
+  TC_DISABLE_COPY_AND_ASSIGN(InputSnapshotPin);
+
+  InputSnapshotPin(InputSnapshot const *snapshot, Atomic<Ulong> *readers)
+      : mSnapshot(snapshot), mReaders(readers) {}
+
+public:
+  /*
+   * @brief: InputSnapshotPin keeps a published snapshot from being reused
+   * while it is read. The slot is released when the pin is destroyed.
+   */
+  InputSnapshotPin() {}
+  InputSnapshotPin(InputSnapshotPin &&other) noexcept
+      : mSnapshot(other.mSnapshot), mReaders(other.mReaders) {
+    other.mSnapshot = nullptr;
+    other.mReaders = nullptr;
+  }
+  ~InputSnapshotPin() { this->Release(); }
+
+  /*
+   * @brief: Unpin the snapshot. The pin is empty afterwards.
+   */
+  void Release() {
+    if (mReaders != nullptr) {
+      mReaders->fetch_sub(1, std::memory_order_release);
+    }
+    mSnapshot = nullptr;
+    mReaders = nullptr;
+  }
+
+  InputSnapshot const &operator*() const { return *mSnapshot; }
+  InputSnapshot const *operator->() const { return mSnapshot; }
+  InputSnapshotPin &operator=(InputSnapshotPin &&other) noexcept {
+    if (this != &other) {
+      this->Release();
+      mSnapshot = other.mSnapshot;
+      mReaders = other.mReaders;
+      other.mSnapshot = nullptr;
+      other.mReaders = nullptr;
+    }
+    return *this;
+  }
+  explicit operator Bool() const { return mSnapshot != nullptr; }
+};
+
+class InputSnapshotRing final : public Object {
+private:
+  static constexpr Size sNumSlots = 8;
+  static constexpr Uint sSlotBits = 8;
+  static constexpr Ulong sSlotMask = ((Ulong)1 << sSlotBits) - 1;
+
+private:
+  InputSnapshot mSlots[sNumSlots];
+  // Current slot in the low bits and the number of Get() calls on it above
+  // them, so a reader pins the current slot with one fetch_add.
+  mutable Atomic<Ulong> mCurrent = 0;
+  // Unreleased pins of retired slots. Publish() adds the Get() count taken
+  // from mCurrent and every pin subtracts one, so a slot is free at zero.
+  mutable Atomic<Ulong> mReaders[sNumSlots] = {};
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(InputSnapshotRing);
+
+public:
+  /*
+   * @brief: InputSnapshotRing hands immutable input snapshots from the
+   * thread polling window events to any number of reader threads.
+   * @detail: Publish() copies the snapshot into a slot nobody is reading
+   * and swaps the current slot. Get() pins the current slot with a single
+   * atomic add, so a reader may keep its snapshot across any number of
+   * publishes. Neither side ever waits: when every other slot is pinned,
+   * Publish() drops the snapshot instead.
+   */
+  InputSnapshotRing() {}
+  ~InputSnapshotRing() override = default;
+
+  /*
+   * @brief: Returns the latest snapshot. This function is thread safe and
+   * wait-free.
+   * @return: Pin of the latest snapshot.
+   */
+  InputSnapshotPin Get() const;
+
+  /*
+   * @brief: Publish a snapshot. Call it from one thread only. This function
+   * is wait-free.
+   * @param: snapshot: Snapshot to publish.
+   * @return: Whether the snapshot was published. It is dropped when readers
+   * still pin every other slot.
+   */
+  Bool Publish(InputSnapshot const &snapshot);
+
+  operator Bool() const override { return true; }
+};
+
+class InputRing final : public Object {
+private:
+  Vec<InputEvent> mEvents;
+  Size mMask = 0;
+  Ulong mEnd = 0;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(InputRing);
+
+public:
+  /*
+   * @brief: InputRing is a fixed-capacity ring buffer of timestamped input
+   * events. Pushing an event never allocates, and the oldest events are
+   * overwritten once the ring is full.
+   * @param: capacity: Number of events kept. Rounded up to a power of two.
+   * @detail: Events are addressed by a sequence number which only grows.
+   * Readers keep their own cursor and call Next() to consume the events
+   * they have not seen. The ring is not thread safe; use it on the thread
+   * polling the window events.
+   */
+  InputRing(Size const &capacity = 1024);
+  ~InputRing() override = default;
+
+  /*
+   * @brief: Returns the number of events the ring holds.
+   * @return: Capacity.
+   */
+  Size GetCapacity() const { return mEvents.size(); }
+  /*
+   * @brief: Returns the sequence number of the oldest event still held.
+   * @return: Sequence number.
+   */
+  Ulong GetBegin() const {
+    return mEnd > mEvents.size() ? mEnd - mEvents.size() : 0;
+  }
+  /*
+   * @brief: Returns the sequence number following the newest event. Start
+   * a cursor here to read only events pushed from now on.
+   * @return: Sequence number.
+   */
+  Ulong GetEnd() const { return mEnd; }
+  /*
+   * @brief: Returns the event with a sequence number.
+   * @param: sequence: Sequence number in [GetBegin(), GetEnd()).
+   * @return: Event.
+   */
+  InputEvent const &Get(Ulong const &sequence) const {
+    return mEvents[sequence & mMask];
+  }
+
+  /*
+   * @brief: Append an event, overwriting the oldest one when full.
+   * @param: event: Event to append.
+   */
+  void Push(InputEvent const &event) { mEvents[mEnd++ & mMask] = event; }
+  /*
+   * @brief: Read the event at a cursor and advance the cursor.
+   * @param: cursor: Sequence number of the next event to read.
+   * @param: event: Receives the event.
+   * @return: false if the cursor reached the newest event.
+   * @detail: A cursor which fell behind the ring skips to the oldest event
+   * still held.
+   */
+  Bool Next(Ulong &cursor, InputEvent &event) const;
+
+  operator Bool() const override { return mEvents.size() > 0; }
+
+public:
+  /*
+   * @brief: Returns the current time in the clock of InputEvent::time.
+   * @return: Steady clock nanoseconds.
+   */
+  static Ulong GetTimestamp();
+};
+} // namespace Core
+} // namespace TerreateCore
+
+#endif // __TC_INPUT_HPP__
@@ -0,0 +1,114 @@
+#ifndef __TC_IO_HPP__
+#define __TC_IO_HPP__
+
+#include <chrono>
+
+#include "defines.hpp"
+#include "job.hpp"
+#include "object.hpp"
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Core;
+using namespace TerreateCore::Defines;
+
+struct IOSystemSettings {
+  Uint minThreads = 0;   // Threads kept alive while idle.
+  Uint maxThreads = 16;  // Upper bound of concurrent blocking requests.
+  Double idleTime = 2.0; // Seconds before an idle extra thread exits.
+};
+
+class IOSystem : public Object {
+private:
+  Map<Thread::id, Thread> mThreads;
+  Vec<Thread> mRetired;
+  Queue<JobBase *> mRequests;
+  Mutex mLock;
+  CondVar mCondition;
+  Atomic<Bool> mStop = false;
+  Uint mNumIdle = 0;
+  IOSystemSettings mSettings;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(IOSystem);
+
+private:
+  void SpawnThread();
+  void JoinRetired();
+  void IOThread();
+
+public:
+  /*
+   * @brief: IOSystem is a thread pool for blocking I/O such as file reads.
+   * Threads are created when every thread is blocked and exit after being
+   * idle for a while, so the pool grows with the number of pending reads.
+   * @param: settings: Settings of the pool.
+   * @detail: Requests complete into futures. Chain them with
+   * Future::Then(jobSystem, ...) to process the data on the CPU workers, or
+   * Future::ThenOnContext(...) to upload it on the OpenGL context thread.
+   * This way CPU workers never block on the disk.
+   */
+  IOSystem(IOSystemSettings const &settings = {});
+  ~IOSystem() override;
+
+  /*
+   * @brief: Returns the number of live I/O threads.
+   * @return: Number of I/O threads.
+   */
+  Uint GetNumThreads();
+  /*
+   * @brief: Returns the number of pending requests.
+   * @return: Number of requests not started yet.
+   */
+  Size GetNumRequests();
+
+  /*
+   * @brief: Stop the I/O threads. Pending requests are skipped.
+   */
+  void Stop();
+  /*
+   * @brief: Execute a job on an I/O thread and transfer its ownership to the
+   * IOSystem.
+   * @param: job: The job to be executed. Must be allocated with new.
+   * @detail: Dependencies of the job are ignored.
+   */
+  void Adopt(JobBase *job);
+  /*
+   * @brief: Execute a blocking function on an I/O thread.
+   * @param: function: The function to be executed.
+   * @return: Future of the function's result.
+   */
+  template <typename F> auto Submit(F &&function) {
+    using R = std::invoke_result_t<F>;
+    Job<R> *job = new Job<R>(std::forward<F>(function));
+    Future<R> future = job->GetFuture();
+    this->Adopt(job);
+    return future;
+  }
+  /*
+   * @brief: Read a whole file on an I/O thread.
+   * @param: path: Path to the file.
+   * @return: Future of the file contents.
+   */
+  Future<Vec<Ubyte>> Read(Str const &path);
+  /*
+   * @brief: Read a whole text file on an I/O thread.
+   * @param: path: Path to the file.
+   * @return: Future of the file contents.
+   */
+  Future<Str> ReadText(Str const &path);
+
+  operator Bool() const override { return !mStop; }
+
+public:
+  /*
+   * @brief: Read a whole file on the calling thread.
+   * @param: path: Path to the file.
+   * @return: File contents.
+   */
+  static Vec<Ubyte> ReadFile(Str const &path);
+};
+} // namespace Job
+} // namespace TerreateCore
+
+#endif // __TC_IO_HPP__
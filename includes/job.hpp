@@ -1,25 +1,132 @@
 #ifndef __TC_JOB_HPP__
 #define __TC_JOB_HPP__
 
+#include <chrono>
+#include <optional>
+
 #include "defines.hpp"
 #include "object.hpp"
+#include "trace.hpp"
 
 namespace TerreateCore {
 namespace Job {
 using namespace TerreateCore::Core;
 using namespace TerreateCore::Defines;
 
+class JobSystem;
+class JobBase;
+
+class CancelToken {
+private:
+  friend class JobBase;
+
+private:
+  Shared<Atomic<Bool>> mCancelled = std::make_shared<Atomic<Bool>>(false);
+
+public:
+  /*
+   * @brief: CancelToken is shared by the jobs of a group of work that can be
+   * abandoned together. Copies of a token refer to the same state.
+   */
+  CancelToken() {}
+  ~CancelToken() = default;
+
+  /*
+   * @brief: Returns true if the token has been cancelled.
+   * @return: True if the token has been cancelled.
+   */
+  Bool IsCancelled() const {
+    return mCancelled->load(std::memory_order_relaxed);
+  }
+
+  /*
+   * @brief: Cancel the token. Jobs holding it are skipped if they have not
+   * started yet, and running jobs see it through JobBase::IsCancelled().
+   * @sa: JobSystem::Cancel()
+   */
+  void Cancel() { mCancelled->store(true, std::memory_order_relaxed); }
+
+  Bool operator==(CancelToken const &other) const {
+    return mCancelled == other.mCancelled;
+  }
+  operator Bool() const { return this->IsCancelled(); }
+};
+
+class JobCounter {
+private:
+  Atomic<Size> mCount = 0;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(JobCounter);
+
+public:
+  /*
+   * @brief: JobCounter counts the unfinished jobs scheduled with it, so a
+   * caller can wait for its own jobs only.
+   * @sa: JobSystem::Wait()
+   */
+  JobCounter() {}
+  ~JobCounter() = default;
+
+  /*
+   * @brief: Returns the number of unfinished jobs.
+   * @return: Number of unfinished jobs.
+   */
+  Size GetCount() const { return mCount.load(std::memory_order_acquire); }
+
+  /*
+   * @brief: Add unfinished jobs to the counter.
+   * @param: count: Number of jobs.
+   */
+  void Add(Size const &count = 1) { mCount.fetch_add(count); }
+  /*
+   * @brief: Mark one job as finished and wake up waiting threads when the
+   * counter reaches zero.
+   */
+  void Done() {
+    if (mCount.fetch_sub(1) == 1) {
+      mCount.notify_all();
+    }
+  }
+  /*
+   * @brief: Block until the counter reaches zero or changes.
+   * @param: count: The count last seen by the caller.
+   */
+  void WaitChange(Size const &count) const { mCount.wait(count); }
+
+  operator Bool() const { return this->GetCount() == 0; }
+};
+
 class JobBase : public Object {
 private:
   friend class JobSystem;
+  friend class IOSystem;
 
 private:
-  Bool mFinished;
+  Atomic<Bool> mFinished = false;
+  Bool mAdopted = false;
+  Bool mSkipped = false;
+  JobCounter *mCounter = nullptr;
+  Shared<Atomic<Bool>> mCancelled;
+  std::chrono::steady_clock::time_point mDeadline =
+      std::chrono::steady_clock::time_point::max();
+  Str mName;
+  Ulong mScheduledAt = 0;
   Vec<JobBase *> mDependencies;
   std::exception_ptr mException = nullptr;
 
 private:
   void Run();
+  void Skip();
+
+protected:
+  /*
+   * @brief: Called once the job has finished executing, whether it succeeded
+   * or not.
+   * @param: exception: The exception thrown by Execute(), or nullptr.
+   */
+  virtual void
+  OnFinished([[maybe_unused]] std::exception_ptr const &exception) {}
 
 public:
   /*
@@ -43,6 +150,59 @@ public:
   JobBase(Vec<JobBase *> const &dependencies) : mDependencies(dependencies) {}
   virtual ~JobBase() override = default;
 
+  /*
+   * @brief: Returns the name of the job shown in traces.
+   * @return: The name of the job.
+   */
+  Str const &GetName() const { return mName; }
+
+  /*
+   * @brief: Set the name of the job shown in traces.
+   * @param: name: The name of the job.
+   */
+  void SetName(Str const &name) { mName = name; }
+  /*
+   * @brief: Attach a cancel token to the job.
+   * @param: token: The cancel token.
+   */
+  void SetCancelToken(CancelToken const &token) {
+    mCancelled = token.mCancelled;
+  }
+  /*
+   * @brief: Set the time after which the job is skipped instead of executed.
+   * @param: deadline: The deadline.
+   */
+  void SetDeadline(std::chrono::steady_clock::time_point const &deadline) {
+    mDeadline = deadline;
+  }
+  /*
+   * @brief: Set the deadline relative to now.
+   * @param: timeout: Time in seconds after which the job is skipped.
+   */
+  void SetTimeout(Double const &timeout);
+
+  /*
+   * @brief: Returns true if the cancel token of the job has been cancelled.
+   * Long running jobs should poll this and return early.
+   * @return: True if the job has been cancelled.
+   */
+  Bool IsCancelled() const {
+    return mCancelled && mCancelled->load(std::memory_order_relaxed);
+  }
+  /*
+   * @brief: Returns true if the deadline of the job has passed.
+   * @return: True if the deadline of the job has passed.
+   */
+  Bool IsExpired() const {
+    return mDeadline != std::chrono::steady_clock::time_point::max() &&
+           std::chrono::steady_clock::now() >= mDeadline;
+  }
+  /*
+   * @brief: Returns true if the job was cancelled or expired before it was
+   * executed.
+   * @return: True if the job was skipped.
+   */
+  Bool IsSkipped() const { return mSkipped; }
   /*
    * @brief: Returns true if the job is ready to be executed.
    * @return: True if the job is ready to be executed.
@@ -53,6 +213,16 @@ public:
    * @return: True if the job has finished executing.
    */
   Bool IsFinished() const { return mFinished; }
+  /*
+   * @brief: Returns true if the job threw an exception while executing.
+   * @return: True if the job threw an exception while executing.
+   */
+  Bool HasException() const { return mException != nullptr; }
+  /*
+   * @brief: Rethrows the exception captured while executing the job. Does
+   * nothing if the job finished without an exception.
+   */
+  void Rethrow() const;
   /*
    * @brief: Overload this function to execute the job.
    */
@@ -88,7 +258,7 @@ public:
    * executed.
    */
   SimpleJob(Function<void()> const &target, JobBase *const dependency)
-      : mFunction(target) {}
+      : JobBase(dependency), mFunction(target) {}
   /*
    * @brief: SimpleJob is a wrapper for a function that can be executed by the
    * JobSystem. It can be used to execute a function asynchronously, or to
@@ -98,7 +268,7 @@ public:
    * executed.
    */
   SimpleJob(Function<void()> const &target, Vec<JobBase *> const &dependencies)
-      : mFunction(target) {}
+      : JobBase(dependencies), mFunction(target) {}
   virtual ~SimpleJob() override = default;
 
   /*
@@ -110,30 +280,338 @@ public:
   virtual operator Bool() const override { return this->IsFinished(); }
 };
 
+template <typename T> struct FutureResult {
+  using Type = T const &;
+};
+template <> struct FutureResult<void> {
+  using Type = void;
+};
+
+template <typename T> class FutureState {
+private:
+  using Storage = std::conditional_t<std::is_void_v<T>, Bool, T>;
+
+private:
+  mutable Mutex mLock;
+  mutable CondVar mCondition;
+  Bool mReady = false;
+  std::optional<Storage> mValue;
+  std::exception_ptr mException = nullptr;
+  Vec<Function<void()>> mContinuations;
+
+private:
+  void Complete(UniqueLock<Mutex> &lock);
+
+public:
+  /*
+   * @brief: FutureState is the shared storage between a Job<T> and the
+   * Future<T> handles referring to its result.
+   */
+  FutureState() {}
+  ~FutureState() = default;
+
+  /*
+   * @brief: Returns true if a value or an exception has been stored.
+   * @return: True if the state is ready.
+   */
+  Bool IsReady() const;
+  /*
+   * @brief: Store the result. Does nothing if the state is already ready.
+   * @param: args: Arguments used to construct the result.
+   * @return: True if the result was stored.
+   */
+  template <typename... Args> Bool SetValue(Args &&...args);
+  /*
+   * @brief: Store an exception. Does nothing if the state is already ready.
+   * @param: exception: The exception to store.
+   * @return: True if the exception was stored.
+   */
+  Bool SetException(std::exception_ptr const &exception);
+  /*
+   * @brief: Register a function called once the state becomes ready. If the
+   * state is already ready, the function is called immediately.
+   * @param: continuation: The function to be called.
+   */
+  void OnReady(Function<void()> const &continuation);
+  /*
+   * @brief: Block until the state becomes ready.
+   */
+  void Wait() const;
+  /*
+   * @brief: Wait for the result and return it. Rethrows the stored exception
+   * if there is one.
+   * @return: The stored result.
+   */
+  typename FutureResult<T>::Type Get() const;
+};
+
+template <typename T> class Future {
+private:
+  Shared<FutureState<T>> mState;
+
+private:
+  template <typename F>
+  auto Continue(JobSystem &system, F &&function, Bool const &onContext) const;
+
+public:
+  using Result = typename FutureResult<T>::Type;
+
+public:
+  /*
+   * @brief: Future is a handle to the result of a Job<T>. Copies of a future
+   * refer to the same result.
+   */
+  Future() {}
+  /*
+   * @brief: Future is a handle to the result of a Job<T>. Copies of a future
+   * refer to the same result.
+   * @param: state: The shared state holding the result.
+   */
+  Future(Shared<FutureState<T>> const &state) : mState(state) {}
+  ~Future() = default;
+
+  /*
+   * @brief: Returns true if the future refers to a result.
+   * @return: True if the future refers to a result.
+   */
+  Bool IsValid() const { return mState != nullptr; }
+  /*
+   * @brief: Returns true if the result is available.
+   * @return: True if the result is available.
+   */
+  Bool IsReady() const { return mState->IsReady(); }
+  /*
+   * @brief: Block until the result is available.
+   */
+  void Wait() const { mState->Wait(); }
+  /*
+   * @brief: Wait for the result and return it. If the job threw an exception,
+   * the exception is rethrown here.
+   * @return: The result of the job.
+   */
+  Result Get() const { return mState->Get(); }
+  /*
+   * @brief: Register a function called once the result is available. The
+   * function is called on the thread which completes the result.
+   * @param: continuation: The function to be called.
+   */
+  void OnReady(Function<void()> const &continuation) const {
+    mState->OnReady(continuation);
+  }
+  /*
+   * @brief: Schedule a continuation on the JobSystem once the result is
+   * available. No thread waits or polls for the result.
+   * @param: system: The JobSystem executing the continuation.
+   * @param: function: The continuation. It receives the result of this
+   * future (nothing if T is void).
+   * @return: Future of the continuation result.
+   * @detail: If this future holds an exception, the continuation is not
+   * called and the exception is forwarded to the returned future.
+   */
+  template <typename F> auto Then(JobSystem &system, F &&function) const;
+  /*
+   * @brief: Schedule a continuation on the thread owning the OpenGL context
+   * once the result is available.
+   * @param: system: The JobSystem whose context queue runs the continuation.
+   * @param: function: The continuation. It receives the result of this
+   * future (nothing if T is void).
+   * @return: Future of the continuation result.
+   * @sa: JobSystem::ScheduleOnContext()
+   */
+  template <typename F>
+  auto ThenOnContext(JobSystem &system, F &&function) const;
+
+  operator Bool() const { return this->IsValid() && this->IsReady(); }
+};
+
+template <typename T> class Job : public JobBase {
+private:
+  Function<T()> mFunction;
+  Shared<FutureState<T>> mState = std::make_shared<FutureState<T>>();
+
+protected:
+  virtual void OnFinished(std::exception_ptr const &exception) override {
+    if (exception) {
+      mState->SetException(exception);
+    }
+  }
+
+public:
+  /*
+   * @brief: Job is a job which produces a value of type T. The value, or the
+   * exception thrown while producing it, is delivered through a Future<T>.
+   * @param: target: The function to be executed.
+   */
+  Job(Function<T()> const &target) : mFunction(target) {}
+  /*
+   * @brief: Job is a job which produces a value of type T. The value, or the
+   * exception thrown while producing it, is delivered through a Future<T>.
+   * @param: target: The function to be executed.
+   * @param: dependency: The job that must be finished before this job can be
+   * executed.
+   */
+  Job(Function<T()> const &target, JobBase *const dependency)
+      : JobBase(dependency), mFunction(target) {}
+  /*
+   * @brief: Job is a job which produces a value of type T. The value, or the
+   * exception thrown while producing it, is delivered through a Future<T>.
+   * @param: target: The function to be executed.
+   * @param: dependencies: The jobs that must be finished before this job can
+   * be executed.
+   */
+  Job(Function<T()> const &target, Vec<JobBase *> const &dependencies)
+      : JobBase(dependencies), mFunction(target) {}
+  virtual ~Job() override = default;
+
+  /*
+   * @brief: Returns the future of this job's result.
+   * @return: Future of the result.
+   * @detail: A job produces a single result. Scheduling it again does not
+   * reset its future.
+   */
+  Future<T> GetFuture() const { return Future<T>(mState); }
+
+  /*
+   * @brief: Executes the target function and stores its result.
+   */
+  virtual void Execute() override {
+    if constexpr (std::is_void_v<T>) {
+      mFunction();
+      mState->SetValue();
+    } else {
+      mState->SetValue(mFunction());
+    }
+  }
+};
+
+struct JobTimer {
+public:
+  ID id = 0;
+  JobBase *job = nullptr;
+  std::chrono::steady_clock::time_point due;
+  std::chrono::steady_clock::duration period;
+  Bool fired = false;
+
+public:
+  Bool operator>(JobTimer const &other) const { return due > other.due; }
+};
+
+struct IdlePolicy {
+public:
+  Uint maxSpins = 2048; // Pause iterations before yielding.
+  Uint minSpins = 64;   // Lower bound of adaptive spinning.
+  Uint yields = 8;      // Yields before parking on the condition variable.
+  Bool adaptive = true; // Adapt spinning to recent queue activity.
+};
+
+struct JobSystemSettings {
+public:
+  Uint numThreads = 0;     // 0 creates one worker per usable cpu.
+  Vec<Uint> cpus;          // Cpus the workers may run on. Empty means all.
+  Vec<Uint> reservedCpus;  // Cpus kept free for render or input threads.
+  Bool pinWorkers = false; // Pin each worker to a single cpu.
+  IdlePolicy idle;         // How idle workers wait for jobs.
+};
+
 class JobSystem : public Object {
 private:
   Queue<JobBase *> mJobs;
   Vec<Thread> mWorkers;
   Vec<Thread> mDaemons;
+  Queue<JobBase *> mContextJobs;
   Mutex mJobLock;
+  Mutex mContextLock;
   CondVar mCondition;
-  Atomic<Bool> mComplete = false;
+  Atomic<Bool> mComplete = true;
   Atomic<Bool> mStop = false;
   Atomic<Uint> mNumJobs = 0;
+  Atomic<Size> mNumQueued = 0;
+  Atomic<Uint> mNumParked = 0;
+  // Bumped whenever a queued job may have become runnable.
+  Atomic<Ulong> mProgress = 0;
+  IdlePolicy mIdlePolicy;
+  JobTracer mTracer;
+  Thread mTimerThread;
+  Mutex mTimerLock;
+  CondVar mTimerCondition;
+  std::priority_queue<JobTimer, Vec<JobTimer>, std::greater<JobTimer>> mTimers;
+  Set<ID> mActiveTimers;
+  ID mNextTimer = 1;
 
 private:
-  void WorkerThread();
+  // Lock waits shorter than this are not traced.
+  static constexpr Ulong sLockWaitThreshold = 1000;
+  // Trace thread index of threads which are not traced.
+  static constexpr Uint sUntraced = ~0u;
+  // Parked workers recheck blocked jobs at this interval, in case their
+  // dependencies finish outside the JobSystem.
+  static constexpr std::chrono::milliseconds sBlockedPoll{1};
+
+private:
+  JobBase *AcquireJob(Uint const &thread);
+  void Idle(Uint const &thread, Uint &spins, Ulong const &progress);
+  void NotifyProgress();
+  void RunJob(JobBase *job, Uint const &thread);
+  Uint GetTraceThread() const;
+  void SkipJob(JobBase *job);
+  void FinishJobs(Uint const &count);
+  void DropCancelled(Queue<JobBase *> &jobs, Vec<JobBase *> &dropped);
+  void WorkerThread(Uint const &id);
   void DaemonThread(JobBase *job);
+  void TimerThread();
+  ID AddTimer(JobBase *job, std::chrono::steady_clock::time_point const &due,
+              std::chrono::steady_clock::duration const &period);
 
 public:
   /*
    * @brief: JobSystem is a thread pool that can be used to execute jobs
    * asynchronously.
    * @param: numThreads: The number of threads to be used by the JobSystem.
+   * @param: idle: How idle workers wait for jobs.
+   * @detail: An idle worker first spins with a pause instruction, then
+   * yields, then parks on a condition variable. Schedule() only wakes a
+   * worker when one is parked.
+   */
+  JobSystem(Uint const &numThreads = std::thread::hardware_concurrency(),
+            IdlePolicy const &idle = IdlePolicy());
+  /*
+   * @brief: JobSystem is a thread pool that can be used to execute jobs
+   * asynchronously.
+   * @param: settings: Worker count and cpu affinity of the workers.
+   * @detail: Use CpuTopology to build one JobSystem per NUMA node or per
+   * core type, and reservedCpus to keep cpus free for other threads.
    */
-  JobSystem(Uint const &numThreads = std::thread::hardware_concurrency());
+  JobSystem(JobSystemSettings const &settings);
   virtual ~JobSystem() override { this->Stop(); }
 
+  /*
+   * @brief: Returns the number of worker threads.
+   * @return: Number of worker threads.
+   */
+  Uint GetNumWorkers() const { return mWorkers.size(); }
+  /*
+   * @brief: Returns the tracer recording the activity of the workers.
+   * @return: The tracer.
+   */
+  JobTracer const &GetTracer() const { return mTracer; }
+
+  /*
+   * @brief: Start recording job executions, queue wait times, lock waits
+   * and idle times of every worker and of the context thread.
+   * @param: capacity: Number of events kept per thread.
+   */
+  void EnableTracing(Size const &capacity = 1 << 16);
+  /*
+   * @brief: Stop recording. Recorded events are kept.
+   */
+  void DisableTracing() { mTracer.Disable(); }
+  /*
+   * @brief: Write the recorded events to a Chrome trace JSON file.
+   * @param: path: Output file path.
+   * @return: True if the file was written.
+   */
+  Bool ExportTrace(Str const &path) const;
+
   /*
    * @brief: Stop the JobSystem and stop all job executions.
    */
@@ -141,23 +619,396 @@ public:
   /*
    * @brief: Schedule a job to be executed.
    * @param: job: The job to be executed.
+   * @param: counter: Counter tracking the job until it finishes, or nullptr.
+   */
+  virtual void Schedule(JobBase *job, JobCounter *counter = nullptr);
+  /*
+   * @brief: Cancel a token and drop every queued job holding it. Running
+   * jobs holding the token keep running until they poll
+   * JobBase::IsCancelled().
+   * @param: token: The token to cancel.
+   * @return: Number of dropped jobs.
+   * @detail: Dropped jobs are finished without being executed, and Job<T>
+   * futures of dropped jobs hold an exception.
+   */
+  virtual Size Cancel(CancelToken &token);
+  /*
+   * @brief: Schedule a job whose ownership is transferred to the JobSystem.
+   * The job is deleted after it finishes executing.
+   * @param: job: The job to be executed. Must be allocated with new.
+   * @param: counter: Counter tracking the job until it finishes, or nullptr.
+   */
+  virtual void Adopt(JobBase *job, JobCounter *counter = nullptr);
+  /*
+   * @brief: Schedule a function to be executed and return the future of its
+   * result.
+   * @param: function: The function to be executed.
+   * @return: Future of the function's result.
+   */
+  template <typename F> auto Submit(F &&function) {
+    using R = std::invoke_result_t<F>;
+    Job<R> *job = new Job<R>(std::forward<F>(function));
+    Future<R> future = job->GetFuture();
+    this->Adopt(job);
+    return future;
+  }
+  /*
+   * @brief: Schedule a job to be executed by the thread owning the OpenGL
+   * context, the next time it calls ProcessContextJobs().
+   * @param: job: The job to be executed.
+   * @detail: Use this to hand the OpenGL part of a job (buffer, texture or
+   * shader uploads) back to the context thread. Context jobs are not
+   * counted by WaitForAll().
+   */
+  virtual void ScheduleOnContext(JobBase *job);
+  /*
+   * @brief: Schedule a job on the context thread whose ownership is
+   * transferred to the JobSystem. The job is deleted after it finishes.
+   * @param: job: The job to be executed. Must be allocated with new.
+   */
+  virtual void AdoptOnContext(JobBase *job);
+  /*
+   * @brief: Schedule a function to be executed by the context thread and
+   * return the future of its result.
+   * @param: function: The function to be executed.
+   * @return: Future of the function's result.
+   */
+  template <typename F> auto SubmitToContext(F &&function) {
+    using R = std::invoke_result_t<F>;
+    Job<R> *job = new Job<R>(std::forward<F>(function));
+    Future<R> future = job->GetFuture();
+    this->AdoptOnContext(job);
+    return future;
+  }
+  /*
+   * @brief: Execute jobs scheduled on the context thread until the queue is
+   * empty or the time budget is used up. Must be called by the thread
+   * owning the OpenGL context.
+   * @param: budget: Time budget in seconds. At least one job is executed.
+   * @return: Number of executed jobs.
+   */
+  Uint ProcessContextJobs(Double const &budget);
+  /*
+   * @brief: Returns the number of jobs waiting for the context thread.
+   * @return: Number of waiting jobs.
+   */
+  Size GetNumContextJobs();
+  /*
+   * @brief: Schedule a job to be executed after a delay.
+   * @param: job: The job to be executed.
+   * @param: delay: Delay in seconds.
+   * @return: Timer id which can be passed to CancelTimer().
+   */
+  ID ScheduleAfter(JobBase *job, Double const &delay);
+  /*
+   * @brief: Schedule a job to be executed at a point in time.
+   * @param: job: The job to be executed.
+   * @param: time: The time at which the job is scheduled.
+   * @return: Timer id which can be passed to CancelTimer().
    */
-  virtual void Schedule(JobBase *job);
+  ID ScheduleAt(JobBase *job,
+                std::chrono::steady_clock::time_point const &time);
+  /*
+   * @brief: Schedule a job to be executed periodically.
+   * @param: job: The job to be executed.
+   * @param: period: Period in seconds. The first execution happens after one
+   * period.
+   * @return: Timer id which can be passed to CancelTimer().
+   * @detail: All timers are served by a single thread which sleeps until the
+   * next timer is due and then schedules the job on the workers. If the job
+   * is still queued or running when it is due again, that execution is
+   * skipped.
+   */
+  ID ScheduleEvery(JobBase *job, Double const &period);
+  /*
+   * @brief: Cancel a timer created by ScheduleAfter(), ScheduleAt() or
+   * ScheduleEvery(). Executions which are already scheduled are not
+   * cancelled.
+   * @param: timer: Timer id.
+   * @return: True if the timer was active.
+   */
+  Bool CancelTimer(ID const &timer);
   /*
    * @brief: Set a job to be a daemon. A daemon is a job that is executed
    * asynchronously and does not block the JobSystem from stopping.
    * @param: job: The job to be executed.
+   * @sa: ScheduleEvery()
+   * @detail: A daemon occupies a thread and executes the job again as soon
+   * as it returns. Use ScheduleEvery() for work that only has to run at a
+   * fixed rate.
    */
   virtual void Daemonize(JobBase *job) {
     mDaemons.emplace_back(Thread([this, job] { this->DaemonThread(job); }));
   }
   /*
-   * @brief: Wait for all jobs to finish executing.
+   * @brief: Wait for the jobs tracked by a counter to finish. The calling
+   * thread executes queued jobs while it waits, so waiting from inside a job
+   * doesn't block a worker.
+   * @param: counter: The counter to wait for.
    */
-  virtual void WaitForAll() { mComplete.wait(false); }
+  virtual void Wait(JobCounter const &counter);
+  /*
+   * @brief: Wait for all jobs to finish executing. The calling thread
+   * executes queued jobs while it waits.
+   */
+  virtual void WaitForAll();
 
   virtual operator Bool() const override { return mComplete; }
 };
+
+class JobGroup final : public Object {
+private:
+  JobSystem &mSystem;
+  JobCounter mCounter;
+  CancelToken mCancelToken;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(JobGroup);
+
+public:
+  /*
+   * @brief: JobGroup is a set of jobs on a JobSystem which can be waited for
+   * and cancelled independently of other jobs on the same JobSystem.
+   * @param: system: The JobSystem executing the jobs.
+   */
+  JobGroup(JobSystem &system) : mSystem(system) {}
+  ~JobGroup() override { this->Wait(); }
+
+  /*
+   * @brief: Returns the number of unfinished jobs of the group.
+   * @return: Number of unfinished jobs.
+   */
+  Size GetCount() const { return mCounter.GetCount(); }
+  /*
+   * @brief: Returns the cancel token shared by the jobs of the group.
+   * @return: The cancel token.
+   */
+  CancelToken const &GetCancelToken() const { return mCancelToken; }
+
+  /*
+   * @brief: Schedule a job as part of the group.
+   * @param: job: The job to be executed.
+   */
+  void Schedule(JobBase *job) {
+    job->SetCancelToken(mCancelToken);
+    mSystem.Schedule(job, &mCounter);
+  }
+  /*
+   * @brief: Schedule a job as part of the group and transfer its ownership
+   * to the JobSystem.
+   * @param: job: The job to be executed. Must be allocated with new.
+   */
+  void Adopt(JobBase *job) {
+    job->SetCancelToken(mCancelToken);
+    mSystem.Adopt(job, &mCounter);
+  }
+  /*
+   * @brief: Schedule a function as part of the group and return the future
+   * of its result.
+   * @param: function: The function to be executed.
+   * @return: Future of the function's result.
+   */
+  template <typename F> auto Submit(F &&function) {
+    using R = std::invoke_result_t<F>;
+    Job<R> *job = new Job<R>(std::forward<F>(function));
+    Future<R> future = job->GetFuture();
+    this->Adopt(job);
+    return future;
+  }
+  /*
+   * @brief: Wait for the jobs of the group, executing queued jobs meanwhile.
+   */
+  void Wait() { mSystem.Wait(mCounter); }
+  /*
+   * @brief: Cancel the group and drop its queued jobs.
+   * @return: Number of dropped jobs.
+   */
+  Size Cancel() { return mSystem.Cancel(mCancelToken); }
+
+  operator Bool() const override { return (Bool)mCounter; }
+};
+
+template <typename T> void FutureState<T>::Complete(UniqueLock<Mutex> &lock) {
+  mReady = true;
+  Vec<Function<void()>> continuations = std::move(mContinuations);
+  mContinuations.clear();
+  lock.unlock();
+  mCondition.notify_all();
+
+  for (auto &continuation : continuations) {
+    continuation();
+  }
+}
+
+template <typename T> Bool FutureState<T>::IsReady() const {
+  LockGuard<Mutex> lock(mLock);
+  return mReady;
+}
+
+template <typename T>
+template <typename... Args>
+Bool FutureState<T>::SetValue(Args &&...args) {
+  UniqueLock<Mutex> lock(mLock);
+  if (mReady) {
+    return false;
+  }
+
+  if constexpr (std::is_void_v<T>) {
+    mValue.emplace(true);
+  } else {
+    mValue.emplace(std::forward<Args>(args)...);
+  }
+  this->Complete(lock);
+  return true;
+}
+
+template <typename T>
+Bool FutureState<T>::SetException(std::exception_ptr const &exception) {
+  UniqueLock<Mutex> lock(mLock);
+  if (mReady) {
+    return false;
+  }
+
+  mException = exception;
+  this->Complete(lock);
+  return true;
+}
+
+template <typename T>
+void FutureState<T>::OnReady(Function<void()> const &continuation) {
+  {
+    UniqueLock<Mutex> lock(mLock);
+    if (!mReady) {
+      mContinuations.push_back(continuation);
+      return;
+    }
+  }
+
+  continuation();
+}
+
+template <typename T> void FutureState<T>::Wait() const {
+  UniqueLock<Mutex> lock(mLock);
+  mCondition.wait(lock, [this] { return mReady; });
+}
+
+template <typename T>
+typename FutureResult<T>::Type FutureState<T>::Get() const {
+  this->Wait();
+  if (mException) {
+    std::rethrow_exception(mException);
+  }
+
+  if constexpr (!std::is_void_v<T>) {
+    return *mValue;
+  }
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::Then(JobSystem &system, F &&function) const {
+  return this->Continue(system, std::forward<F>(function), false);
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::ThenOnContext(JobSystem &system, F &&function) const {
+  return this->Continue(system, std::forward<F>(function), true);
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::Continue(JobSystem &system, F &&function,
+                         Bool const &onContext) const {
+  Future<T> parent = *this;
+  auto target = [parent, function = std::forward<F>(function)]() mutable {
+    if constexpr (std::is_void_v<T>) {
+      parent.Get();
+      return function();
+    } else {
+      return function(parent.Get());
+    }
+  };
+
+  using R = std::invoke_result_t<decltype(target) &>;
+  Job<R> *job = new Job<R>(std::move(target));
+  Future<R> future = job->GetFuture();
+  mState->OnReady([&system, job, onContext] {
+    if (onContext) {
+      system.AdoptOnContext(job);
+    } else {
+      system.Adopt(job);
+    }
+  });
+  return future;
+}
+
+/*
+ * @brief: Create a future which becomes ready once all given futures are
+ * ready.
+ * @param: futures: The futures to wait for.
+ * @return: Future of all results in the given order (void if T is void).
+ * @detail: If any of the futures holds an exception, the first one in the
+ * given order is forwarded to the returned future.
+ */
+template <typename T> auto WhenAll(Vec<Future<T>> const &futures) {
+  using R = std::conditional_t<std::is_void_v<T>, void, Vec<T>>;
+  Shared<FutureState<R>> state = std::make_shared<FutureState<R>>();
+  if (futures.empty()) {
+    state->SetValue();
+    return Future<R>(state);
+  }
+
+  Shared<Vec<Future<T>>> sources = std::make_shared<Vec<Future<T>>>(futures);
+  Shared<Atomic<Size>> remaining =
+      std::make_shared<Atomic<Size>>(futures.size());
+  for (auto const &future : futures) {
+    future.OnReady([state, remaining, sources] {
+      if (remaining->fetch_sub(1) != 1) {
+        return;
+      }
+
+      try {
+        if constexpr (std::is_void_v<T>) {
+          for (auto const &f : *sources) {
+            f.Get();
+          }
+          state->SetValue();
+        } else {
+          Vec<T> results;
+          results.reserve(sources->size());
+          for (auto const &f : *sources) {
+            results.push_back(f.Get());
+          }
+          state->SetValue(std::move(results));
+        }
+      } catch (...) {
+        state->SetException(std::current_exception());
+      }
+    });
+  }
+  return Future<R>(state);
+}
+
+/*
+ * @brief: Create a future which becomes ready once any of the given futures
+ * is ready.
+ * @param: futures: The futures to wait for.
+ * @return: Future of the index of the first future which became ready.
+ */
+template <typename T> Future<Index> WhenAny(Vec<Future<T>> const &futures) {
+  Shared<FutureState<Index>> state = std::make_shared<FutureState<Index>>();
+  if (futures.empty()) {
+    state->SetException(std::make_exception_ptr(
+        Exception::CoreException("WhenAny requires at least one future.")));
+    return Future<Index>(state);
+  }
+
+  for (Index i = 0; i < futures.size(); ++i) {
+    futures[i].OnReady([state, i] { state->SetValue(i); });
+  }
+  return Future<Index>(state);
+}
 } // namespace Job
 } // namespace TerreateCore
 
@@ -0,0 +1,65 @@
+#ifndef __TC_METRICS_HPP__
+#define __TC_METRICS_HPP__
+
+#include "defines.hpp"
+
+namespace TerreateCore {
+namespace Event {
+using namespace TerreateCore::Defines;
+
+struct LatencyHistogram {
+public:
+  // Bucket i counts samples in [2^(i-1), 2^i) nanoseconds.
+  Ulong buckets[64] = {0};
+  Ulong count = 0;
+  Ulong total = 0;
+  Ulong max = 0;
+
+public:
+  /*
+   * @brief: Record a sample.
+   * @param: sample: Sample value, usually in nanoseconds.
+   */
+  void Record(Ulong const &sample);
+  /*
+   * @brief: Returns the mean of the samples.
+   * @return: Mean value.
+   */
+  Double GetMean() const { return count == 0 ? 0.0 : (Double)total / count; }
+  /*
+   * @brief: Returns an upper bound of a percentile of the samples.
+   * @param: percentile: Percentile in [0, 1].
+   * @return: Upper bound of the bucket holding the percentile, capped by the
+   * maximum sample.
+   */
+  Ulong GetPercentile(Double const &percentile) const;
+  /*
+   * @brief: Clear all samples.
+   */
+  void Clear() { *this = LatencyHistogram(); }
+};
+
+struct HandlerMetrics {
+public:
+  Ulong calls = 0;
+  Ulong total = 0; // Nanoseconds.
+  Ulong max = 0;   // Nanoseconds of the slowest call.
+
+public:
+  void Record(Ulong const &duration) {
+    ++calls;
+    total += duration;
+    max = duration > max ? duration : max;
+  }
+};
+
+struct EventMetrics {
+public:
+  Ulong dispatched = 0;
+  LatencyHistogram latency; // Publish to dispatch, in nanoseconds.
+  Ulong handlerTime = 0;    // Nanoseconds spent in ordered handlers.
+};
+} // namespace Event
+} // namespace TerreateCore
+
+#endif // __TC_METRICS_HPP__
@@ -13,7 +13,7 @@ using namespace TerreateCore::Defines;
 class UUID {
 private:
   Byte mUUID[16] = {0};
-  static std::mt19937 sRandomEngine;
+  static thread_local std::mt19937 sRandomEngine;
 
 private:
   void GenerateUUID();
@@ -95,6 +95,14 @@ public:
    * @return: texture data
    */
   static TextureData LoadTexture(Str const &path);
+  /*
+   * @brief: Decodes texture data from an encoded image in memory.
+   * @param: encoded: encoded image such as the contents of a png file
+   * @return: texture data
+   * @detail: Use with IOSystem::Read() to keep disk reads off the job
+   * workers.
+   */
+  static TextureData DecodeTexture(Vec<Ubyte> const &encoded);
 };
 
 class CubeTexture final : public Object {
@@ -0,0 +1,109 @@
+#ifndef __TC_TOPOLOGY_HPP__
+#define __TC_TOPOLOGY_HPP__
+
+#include "defines.hpp"
+#include "object.hpp"
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Core;
+using namespace TerreateCore::Defines;
+
+// Use to select a kind of core on hybrid processors.
+enum class CoreType { UNKNOWN, PERFORMANCE, EFFICIENCY };
+
+struct CpuInfo {
+public:
+  Uint id = 0;
+  Uint package = 0;
+  Uint core = 0;
+  Uint node = 0;
+  CoreType type = CoreType::UNKNOWN;
+};
+
+class CpuTopology : public Object {
+private:
+  Vec<CpuInfo> mCpus;
+
+private:
+  void LoadSysfs();
+
+public:
+  /*
+   * @brief: CpuTopology describes the logical cpus of the machine. On Linux
+   * it is read from /sys/devices/system/cpu, elsewhere every cpu is reported
+   * on package 0 and node 0.
+   */
+  CpuTopology();
+  ~CpuTopology() override = default;
+
+  /*
+   * @brief: Returns all online logical cpus.
+   * @return: Logical cpus.
+   */
+  Vec<CpuInfo> const &GetCpus() const { return mCpus; }
+  /*
+   * @brief: Returns the ids of all online logical cpus.
+   * @return: Cpu ids.
+   */
+  Vec<Uint> GetCpuIDs() const;
+  /*
+   * @brief: Returns the ids of the cpus belonging to a NUMA node.
+   * @param: node: NUMA node id.
+   * @return: Cpu ids.
+   */
+  Vec<Uint> GetCpuIDs(Uint const &node) const;
+  /*
+   * @brief: Returns the ids of the cpus of a core type.
+   * @param: type: Core type.
+   * @return: Cpu ids.
+   */
+  Vec<Uint> GetCpuIDs(CoreType const &type) const;
+  /*
+   * @brief: Returns the NUMA node ids.
+   * @return: NUMA node ids in ascending order.
+   */
+  Vec<Uint> GetNodes() const;
+  /*
+   * @brief: Returns true if the processor has more than one core type.
+   * @return: True if the processor is hybrid.
+   */
+  Bool IsHybrid() const;
+
+  /*
+   * @brief: Split the cpus into one group per NUMA node.
+   * @return: Cpu ids grouped by NUMA node.
+   */
+  Vec<Vec<Uint>> PartitionByNode() const;
+  /*
+   * @brief: Split the cpus into one group per core type. Performance cores
+   * come first.
+   * @return: Cpu ids grouped by core type.
+   */
+  Vec<Vec<Uint>> PartitionByCoreType() const;
+
+  /*
+   * @brief: Restrict a thread to a set of cpus.
+   * @param: thread: The thread to restrict.
+   * @param: cpus: Cpu ids the thread may run on.
+   * @return: True if the affinity was applied.
+   */
+  static Bool SetAffinity(Thread &thread, Vec<Uint> const &cpus);
+  /*
+   * @brief: Restrict the calling thread to a set of cpus. Use this to pin
+   * render or input threads to cpus reserved from the JobSystem.
+   * @param: cpus: Cpu ids the thread may run on.
+   * @return: True if the affinity was applied.
+   */
+  static Bool SetCurrentAffinity(Vec<Uint> const &cpus);
+  /*
+   * @brief: Parse a cpu list such as "0-3,8,10-11".
+   * @param: list: Cpu list.
+   * @return: Cpu ids.
+   */
+  static Vec<Uint> ParseCpuList(Str const &list);
+};
+} // namespace Job
+} // namespace TerreateCore
+
+#endif // __TC_TOPOLOGY_HPP__
@@ -0,0 +1,135 @@
+#ifndef __TC_TRACE_HPP__
+#define __TC_TRACE_HPP__
+
+#include <chrono>
+
+#include "defines.hpp"
+#include "object.hpp"
+
+namespace TerreateCore {
+namespace Job {
+using namespace TerreateCore::Core;
+using namespace TerreateCore::Defines;
+
+// Use to select the kind of a recorded trace event.
+enum class TraceEventType {
+  JOB,       // A job was executed.
+  LOCK_WAIT, // A worker waited for the job queue lock.
+  IDLE,      // A worker waited for jobs to be scheduled.
+  REQUEUE    // A job was dequeued before its dependencies were finished.
+};
+
+struct TraceEvent {
+public:
+  TraceEventType type = TraceEventType::JOB;
+  Ulong start = 0;     // Nanoseconds since tracing was enabled.
+  Ulong end = 0;       // Nanoseconds since tracing was enabled.
+  Ulong queueWait = 0; // Nanoseconds between scheduling and execution.
+  char name[32] = {0};
+};
+
+class TraceBuffer final {
+private:
+  Vec<TraceEvent> mEvents;
+  Size mMask = 0;
+  Atomic<Ulong> mHead = 0;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(TraceBuffer);
+
+public:
+  /*
+   * @brief: TraceBuffer is a fixed size ring of trace events written by a
+   * single thread. When it is full, the oldest events are overwritten.
+   * @param: capacity: Number of events. Rounded up to a power of two.
+   */
+  TraceBuffer(Size const &capacity);
+  ~TraceBuffer() = default;
+
+  /*
+   * @brief: Record an event. Must only be called by the owning thread.
+   * @param: event: The event to record.
+   */
+  void Push(TraceEvent const &event) {
+    Ulong const head = mHead.load(std::memory_order_relaxed);
+    mEvents[head & mMask] = event;
+    mHead.store(head + 1, std::memory_order_release);
+  }
+  /*
+   * @brief: Copy the recorded events. Can be called from any thread. Events
+   * which were overwritten while copying are dropped.
+   * @return: Recorded events, oldest first.
+   */
+  Vec<TraceEvent> Collect() const;
+  /*
+   * @brief: Drop all recorded events. Must not be called while the owning
+   * thread is recording.
+   */
+  void Clear() { mHead.store(0); }
+};
+
+class JobTracer final : public Object {
+private:
+  Vec<std::unique_ptr<TraceBuffer>> mBuffers;
+  Vec<Str> mThreadNames;
+  Atomic<Bool> mEnabled = false;
+  std::chrono::steady_clock::time_point mEpoch;
+
+private:
+  TC_DISABLE_COPY_AND_ASSIGN(JobTracer);
+
+public:
+  /*
+   * @brief: JobTracer records what the threads of a JobSystem are doing into
+   * one TraceBuffer per thread, so recording takes no lock.
+   */
+  JobTracer() {}
+  ~JobTracer() override = default;
+
+  /*
+   * @brief: Returns true if events are being recorded.
+   * @return: True if events are being recorded.
+   */
+  Bool IsEnabled() const {
+    return mEnabled.load(std::memory_order_acquire);
+  }
+  /*
+   * @brief: Returns the current time in the clock of the trace.
+   * @return: Nanoseconds since tracing was enabled.
+   */
+  Ulong Now() const;
+
+  /*
+   * @brief: Allocate the buffers and start recording. Buffers allocated by
+   * a previous call are kept.
+   * @param: threadNames: Name of each recording thread, indexed by thread.
+   * @param: capacity: Number of events per thread.
+   */
+  void Enable(Vec<Str> const &threadNames, Size const &capacity);
+  /*
+   * @brief: Stop recording. Recorded events are kept.
+   */
+  void Disable() { mEnabled.store(false, std::memory_order_release); }
+  /*
+   * @brief: Record an event if tracing is enabled.
+   * @param: thread: Index of the recording thread.
+   * @param: event: The event to record.
+   */
+  void Record(Uint const &thread, TraceEvent const &event) {
+    if (this->IsEnabled()) {
+      mBuffers[thread]->Push(event);
+    }
+  }
+  /*
+   * @brief: Write the recorded events as Chrome trace event JSON, which can
+   * be opened with chrome://tracing or ui.perfetto.dev.
+   * @param: stream: Output stream.
+   */
+  void ExportChromeTrace(std::ostream &stream) const;
+
+  operator Bool() const override { return this->IsEnabled(); }
+};
+} // namespace Job
+} // namespace TerreateCore
+
+#endif // __TC_TRACE_HPP__
@@ -0,0 +1,90 @@
+#ifndef __TC_WHEEL_HPP__
+#define __TC_WHEEL_HPP__
+
+#include "defines.hpp"
+#include "object.hpp"
+
+namespace TerreateCore {
+namespace Event {
+using namespace TerreateCore::Core;
+using namespace TerreateCore::Defines;
+
+class TimerWheel final : public Object {
+private:
+  struct Entry {
+    Ulong due = 0;
+    EventID event = 0;
+    Index prev = 0;
+    Index next = 0;
+    Index slot = 0;
+    Uint generation = 0;
+    Bool active = false;
+  };
+
+private:
+  Vec<Entry> mEntries;
+  Vec<Index> mFree;
+  Vec<Index> mSlots;
+  Ulong mTick = 0;
+  Size mSize = 0;
+
+private:
+  static constexpr Uint sLevelBits = 8;
+  static constexpr Uint sSlotsPerLevel = 1 << sLevelBits;
+  static constexpr Uint sNumLevels = 4;
+  static constexpr Index sNone = ~(Index)0;
+
+private:
+  void Link(Index const &entry);
+  void Unlink(Index const &entry);
+  void Cascade(Uint const &level);
+
+public:
+  /*
+   * @brief: TimerWheel is a hierarchical timing wheel holding events due at
+   * a tick. Adding and cancelling a timer is O(1), and advancing costs one
+   * slot per tick plus the cascades of the upper levels.
+   * @detail: Four levels of 256 slots cover 2^32 ticks. Later timers are
+   * clamped to that horizon.
+   */
+  TimerWheel() : mSlots(sSlotsPerLevel * sNumLevels, sNone) {}
+  ~TimerWheel() override = default;
+
+  /*
+   * @brief: Returns the current tick.
+   * @return: Current tick.
+   */
+  Ulong GetTick() const { return mTick; }
+  /*
+   * @brief: Returns the number of pending timers.
+   * @return: Number of pending timers.
+   */
+  Size GetSize() const { return mSize; }
+
+  /*
+   * @brief: Add a timer.
+   * @param: due: Tick at which the event is due. Past ticks fire on the
+   * next advance.
+   * @param: event: The event to publish.
+   * @return: Timer id which can be passed to Cancel().
+   */
+  Ulong Add(Ulong const &due, EventID const &event);
+  /*
+   * @brief: Cancel a timer.
+   * @param: timer: Timer id.
+   * @return: True if the timer was pending.
+   */
+  Bool Cancel(Ulong const &timer);
+  /*
+   * @brief: Advance the wheel and collect the events which became due.
+   * @param: tick: The tick to advance to.
+   * @param: fired: Due events are appended here, in due order.
+   */
+  void Advance(Ulong const &tick, Vec<EventID> &fired);
+
+  operator Bool() const override { return mSize > 0; }
+};
+} // namespace Event
+} // namespace TerreateCore
+
+#endif // __TC_WHEEL_HPP__
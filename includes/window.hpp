@@ -2,6 +2,8 @@
 #define __TC_WINDOW_HPP__
 
 #include "defines.hpp"
+#include "input.hpp"
+#include "job.hpp"
 #include "object.hpp"
 
 namespace TerreateCore {
@@ -116,6 +118,13 @@ void CharCallbackWrapper(GLFWwindow *window, Uint codepoint);
 void DropCallbackWrapper(GLFWwindow *window, int count, const char **paths);
 } // namespace Callbacks
 
+// Use to select when Window::Frame() executes the JobSystem context queue.
+enum class ContextQueuePoint {
+  BEFORE_FRAME, // Before WindowController::OnFrame().
+  AFTER_FRAME,  // After WindowController::OnFrame().
+  MANUAL        // Only when Window::ProcessContextJobs() is called.
+};
+
 struct WindowSettings {
 public:
   Uint resizable = GLFW_TRUE;
@@ -137,8 +146,13 @@ class WindowProperty {
 private:
   Str mTitle = "GeoFrame";
   Pair<double> mScrollOffset;
+  // Keys, chars, buttons, scroll and cursor moves in arrival order.
+  InputRing mInputs;
+  // Keys and chars until ClearInputs(). Kept apart from the ring so cursor
+  // input cannot evict them before the frame reads them.
   Vec<Uint> mCodePoints;
   Vec<Key> mKeys;
+  InputSnapshot mLiveInput; // Next snapshot, written by the callbacks.
   Vec<Str> mDroppedFiles;
   Pair<Uint> mSize;
   Pair<Uint> mPosition;
@@ -150,6 +164,9 @@ private:
                                              Uint codepoint);
   friend void Callbacks::KeyCallbackWrapper(GLFWwindow *window, int key,
                                             int scancode, int action, int mods);
+  friend void Callbacks::MousebuttonCallbackWrapper(GLFWwindow *window,
+                                                    int button, int action,
+                                                    int mods);
   friend void Callbacks::DropCallbackWrapper(GLFWwindow *window, int count,
                                              const char **paths);
   friend void Callbacks::WindowSizeCallbackWrapper(GLFWwindow *window,
@@ -176,6 +193,11 @@ public:
    * @detail: Return format is (x, y).
    */
   Pair<double> const &GetScrollOffset() const { return mScrollOffset; }
+  /*
+   * @brief: This function returns the input ring.
+   * @return: Input ring.
+   */
+  InputRing const &GetInputs() const { return mInputs; }
   /*
    * @brief: This function returns inputted code points.
    * @return: Inputted code points.
@@ -248,7 +270,26 @@ private:
   GLFWwindow *mWindow = nullptr;
   void *mUserPointer = nullptr;
   WindowProperty mProperty;
+  InputSnapshotRing mInputSnapshots;
   WindowController *mController = nullptr;
+  Job::JobSystem *mJobSystem = nullptr;
+  Double mContextBudget = 0.0;
+  ContextQueuePoint mContextQueuePoint = ContextQueuePoint::BEFORE_FRAME;
+  // Render thread mode. The main thread records mRecordPacket while the
+  // render thread executes mRenderPacket.
+  Thread mRenderThread;
+  Mutex mRenderMutex;
+  CondVar mRenderCondition;
+  Vec<Function<void()>> mRecordPacket;
+  Vec<Function<void()>> mRenderPacket;
+  // Context job settings of mRenderPacket, copied by SubmitPacket() so
+  // SetContextJobSystem() never races with the render thread.
+  Job::JobSystem *mPacketJobSystem = nullptr;
+  Double mPacketBudget = 0.0;
+  ContextQueuePoint mPacketQueuePoint = ContextQueuePoint::BEFORE_FRAME;
+  Bool mPacketReady = false;
+  Bool mRenderBusy = false;
+  Bool mStopRender = false;
 
   friend void Callbacks::WindowPositionCallbackWrapper(GLFWwindow *window,
                                                        int xpos, int ypos);
@@ -288,6 +329,10 @@ private:
 private:
   TC_DISABLE_COPY_AND_ASSIGN(Window);
 
+private:
+  void RenderThread();
+  void SubmitPacket();
+
 public:
   /*
    * @brief: This function creates a glfw window and sets the callbacks.
@@ -354,6 +399,25 @@ public:
    * inputted keys, use ClearInputs() function.
    */
   Vec<Key> const &GetKeys() const { return mProperty.GetKeys(); }
+  /*
+   * @brief: This function returns the input state published by the last
+   * PollEvents() call. This function is thread safe and wait-free.
+   * @return: Input snapshot.
+   * @detail: Use this instead of IsPressing(), GetMousebutton() and
+   * GetCursorPosition() off the main thread. The snapshot is not reused
+   * while the pin is held. PollEvents() never waits for readers; it skips
+   * publishing while every spare slot is pinned, so release the pin when
+   * the frame is done.
+   */
+  InputSnapshotPin GetInputSnapshot() const {
+    return mInputSnapshots.Get();
+  }
+  /*
+   * @brief: This function returns the ring of timestamped input events.
+   * @return: Input ring.
+   * @sa: ReadInput()
+   */
+  InputRing const &GetInputs() const { return mProperty.GetInputs(); }
   /*
    * @brief: This function returns dropped files.
    * @return: Dropped files.
@@ -491,7 +555,27 @@ public:
   void SetWindowController(WindowController *callbacks) {
     mController = callbacks;
   }
+  /*
+   * @brief: This function sets the JobSystem whose context jobs are executed
+   * by this window.
+   * @param: system: JobSystem. nullptr stops executing context jobs.
+   * @param: budget: Time budget per frame in seconds.
+   * @param: point: When Frame() executes the context jobs.
+   * @sa: JobSystem::ScheduleOnContext()
+   */
+  void SetContextJobSystem(
+      Job::JobSystem *system, Double const &budget = 0.002,
+      ContextQueuePoint const &point = ContextQueuePoint::BEFORE_FRAME) {
+    mJobSystem = system;
+    mContextBudget = budget;
+    mContextQueuePoint = point;
+  }
 
+  /*
+   * @brief: This function returns whether the render thread is running.
+   * @return: Whether the render thread is running or not.
+   */
+  Bool IsRenderThreaded() const { return mRenderThread.joinable(); }
   /*
    * @brief: This function returns whether window is closed or not.
    * @return: Whether window is closed or not.
@@ -668,15 +752,70 @@ public:
    */
   void Swap() const { glfwSwapBuffers(mWindow); }
   /*
-   * @brief: This function poll events.
+   * @brief: This function poll events and publishes the input snapshot of
+   * this window.
+   * @sa: GetInputSnapshot()
    */
-  void PollEvents() const { glfwPollEvents(); }
+  void PollEvents();
   /*
    * @brief: This function binds window to current context.
    */
   void Bind() const { glfwMakeContextCurrent(mWindow); }
+  /*
+   * @brief: This function executes context jobs of the JobSystem set by
+   * SetContextJobSystem() within the frame budget.
+   * @return: Number of executed jobs.
+   * @detail: Call this from WindowController::OnFrame() when the context
+   * queue point is ContextQueuePoint::MANUAL. While the render thread runs,
+   * the jobs are recorded into the packet so they run with the context, and
+   * 0 is returned.
+   */
+  Uint ProcessContextJobs();
+  /*
+   * @brief: This function reads the next input event after a cursor.
+   * @param: cursor: Sequence number of the next event to read. Start it at
+   * GetInputs().GetEnd() to read only new events.
+   * @param: event: Receives the event.
+   * @return: false if there is no newer event.
+   * @detail: Every consumer keeps its own cursor, so reading doesn't clear
+   * events for other consumers.
+   */
+  Bool ReadInput(Ulong &cursor, InputEvent &event) const {
+    return mProperty.GetInputs().Next(cursor, event);
+  }
+  /*
+   * @brief: This function clears inputted code points, inputted keys, and
+   * dropped files.
+   */
+  void ClearInputs() { mProperty.ClearInputs(); }
+  /*
+   * @brief: This function moves the OpenGL context to a dedicated render
+   * thread.
+   * @sa: Record()
+   * @detail: The main thread keeps polling events and runs
+   * WindowController::OnFrame(), which records the OpenGL work of the frame
+   * with Record(). Frame() hands the recorded packet to the render thread,
+   * which executes it, runs the context jobs and swaps the buffers, while
+   * the main thread builds the next frame. OpenGL functions must not be
+   * called directly from the main thread in this mode, including Fill(),
+   * Clear(), Bind() and Swap().
+   */
+  void StartRenderThread();
+  /*
+   * @brief: This function stops the render thread after it finishes the
+   * submitted packet, and makes the context current on the calling thread.
+   */
+  void StopRenderThread();
+  /*
+   * @brief: This function records an OpenGL command for the current frame.
+   * @param: command: Command executed with the context current.
+   * @detail: Without a render thread the command is executed at once.
+   */
+  void Record(Function<void()> command);
   /*
    * @brief: This function executes callbacks->Run().
+   * @detail: With a render thread, this function then waits until the
+   * previous packet is rendered and submits the recorded one.
    */
   void Frame();
 
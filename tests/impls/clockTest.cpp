@@ -0,0 +1,44 @@
+#include "../includes/clockTest.hpp"
+
+using namespace TerreateCore::Core;
+
+void frame_test() {
+  Clock clock;
+  Uint const fps = 120;
+  Double const target = 1.0 / fps;
+  Uint accurate = 0;
+  for (int i = 0; i < 240; ++i) {
+    clock.Frame(fps);
+    if (i > 0 && std::abs(clock.GetDeltaTime() - target) <= 1e-4) {
+      ++accurate;
+    }
+  }
+
+  FrameStats const &stats = clock.GetStats();
+  std::cout << "Frames: " << stats.frames << ", missed: " << stats.missed
+            << std::endl;
+  std::cout << "Frame time: mean " << stats.mean * 1e3 << "ms, min "
+            << stats.min * 1e3 << "ms, max " << stats.max * 1e3
+            << "ms, deviation " << stats.deviation * 1e3 << "ms" << std::endl;
+  std::cout << "Within 0.1ms: " << accurate << "/239" << std::endl;
+}
+
+void fixed_step_test() {
+  Clock clock;
+  clock.SetFixedStep(1.0 / 60.0);
+  Uint steps = 0;
+  for (int i = 0; i < 144; ++i) {
+    clock.Frame(144);
+    while (clock.ConsumeStep()) {
+      ++steps;
+    }
+  }
+  std::cout << "Fixed steps in one second: " << steps
+            << ", alpha: " << clock.GetAlpha() << std::endl;
+}
+
+int main() {
+  frame_test();
+  fixed_step_test();
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include "../includes/eventBench.hpp"
+
+using namespace TerreateCore::Event;
+
+struct MoveEvent {
+  Float x;
+  Float y;
+};
+
+Vec<BenchResult> sResults;
+
+template <typename P>
+BenchResult MeasurePublish(Str const &bench, Uint const &producers,
+                           P const &publish) {
+  Size const perProducer = 200000;
+  Size const sampleEvery = 64;
+  EventSystem events;
+  Atomic<Size> received = 0;
+  EventID const id = events.GetEventID("id");
+  events.Register(id, [&received](Str const &) { received++; });
+  events.Register<MoveEvent>([&received](MoveEvent const &) { received++; });
+
+  Vec<Vec<Double>> samples(producers);
+  Atomic<Bool> start = false;
+  Vec<Thread> threads;
+  for (Uint p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      while (!start.load()) {
+        std::this_thread::yield();
+      }
+      for (Size i = 0; i < perProducer; ++i) {
+        if (i % sampleEvery != 0) {
+          publish(events, id, i);
+          continue;
+        }
+        Long const begin = Now();
+        publish(events, id, i);
+        samples[p].push_back(ToMicroseconds(Now() - begin));
+      }
+    });
+  }
+
+  // The consumer dispatches like a frame loop while producers publish.
+  Size const total = perProducer * producers;
+  Long const begin = Now();
+  start.store(true);
+  while (received.load() < total) {
+    events.ProcessEvents();
+    std::this_thread::yield();
+  }
+  Long const end = Now();
+  for (Thread &thread : threads) {
+    thread.join();
+  }
+
+  BenchResult result{bench, "producers=" + std::to_string(producers), {}, 0.0};
+  for (Vec<Double> const &producer : samples) {
+    result.samples.insert(result.samples.end(), producer.begin(),
+                          producer.end());
+  }
+  result.throughput = total / (ToMicroseconds(end - begin) / 1e6);
+  return result;
+}
+
+void publish_bench() {
+  Uint const hardware = std::max(1u, std::thread::hardware_concurrency());
+  for (Uint producers = 1; producers <= std::max(4u, hardware);
+       producers *= 2) {
+    sResults.push_back(
+        MeasurePublish("publish_id", producers,
+                       [](EventSystem &events, EventID id, Size) {
+                         events.PublishEvent(id);
+                       }));
+    sResults.push_back(MeasurePublish(
+        "publish_typed", producers, [](EventSystem &events, EventID, Size i) {
+          events.Publish<MoveEvent>((Float)i, (Float)i);
+        }));
+  }
+}
+
+int main(int argc, char **argv) {
+  publish_bench();
+
+  WriteReport(std::cout, sResults);
+  if (argc > 1) {
+    std::ofstream file(argv[1]);
+    WriteReport(file, sResults);
+  }
+  return 0;
+}
@@ -0,0 +1,313 @@
+#include "../includes/eventTest.hpp"
+
+using namespace TerreateCore::Event;
+using namespace TerreateCore::Job;
+
+struct ResizeEvent {
+  Uint width;
+  Uint height;
+};
+
+struct CursorEvent {
+  Double x;
+  Double y;
+  static constexpr CoalescePolicy sCoalescePolicy = CoalescePolicy::LATEST;
+};
+
+struct ScrollEvent {
+  Double offset;
+  static constexpr CoalescePolicy sCoalescePolicy = CoalescePolicy::MERGE;
+
+  void Merge(ScrollEvent const &newer) { offset += newer.offset; }
+};
+
+struct TextEvent {
+  Str text;
+};
+
+void event_test() {
+  EventSystem events;
+  EventID const resize = events.GetEventID("resize");
+  events.Register(resize, [](Str const &event) {
+    std::cout << "Callback: " << event << std::endl;
+  });
+  events.Register("close", [](Str const &event) {
+    std::cout << "Callback: " << event << std::endl;
+  });
+  events.AddTrigger("close", [](Str const &event) {
+    std::cout << "Trigger: " << event << std::endl;
+  });
+
+  std::cout << "Interned: " << (events.GetEventID("resize") == resize)
+            << std::endl;
+  events.PublishEvent(resize);
+  events.PublishEvent("close");
+  events.PublishEvent("unhandled");
+  events.ProcessEvents();
+  events.PublishEvent("close");
+  events.ProcessEvents();
+
+  // Publishing from a callback is deferred to the next ProcessEvents call.
+  events.AddTrigger("reload", [&events](Str const &event) {
+    std::cout << "Trigger: " << event << std::endl;
+    events.PublishEvent("close");
+  });
+  events.PublishEvent("reload");
+  events.ProcessEvents();
+  events.ProcessEvents();
+}
+
+void typed_event_test() {
+  EventSystem events;
+  events.Register<ResizeEvent>([](ResizeEvent const &event) {
+    std::cout << "Resize: " << event.width << "x" << event.height
+              << std::endl;
+  });
+  events.Register<TextEvent>([](TextEvent const &event) {
+    std::cout << "Text: " << event.text << std::endl;
+  });
+
+  for (int frame = 0; frame < 2; ++frame) {
+    events.Publish<ResizeEvent>(640u + frame, 480u);
+    events.Publish<TextEvent>("frame " + std::to_string(frame));
+    events.ProcessEvents();
+  }
+}
+
+void concurrent_event_test() {
+  JobSystem jobs;
+  EventSystem events;
+  events.SetJobSystem(&jobs);
+
+  Atomic<Uint> area = 0;
+  for (int i = 0; i < 100; ++i) {
+    events.Register<ResizeEvent>(
+        [&area](ResizeEvent const &event) {
+          area += event.width * event.height;
+        },
+        DispatchPolicy::CONCURRENT);
+  }
+  Vec<Uint> widths;
+  events.Register<ResizeEvent>(
+      [&widths](ResizeEvent const &event) { widths.push_back(event.width); });
+
+  for (Uint i = 1; i <= 3; ++i) {
+    events.Publish<ResizeEvent>(i, 2u);
+  }
+  events.ProcessEvents();
+  std::cout << "Concurrent area: " << area << std::endl;
+  std::cout << "Ordered widths: " << widths[0] << widths[1] << widths[2]
+            << std::endl;
+}
+
+void delayed_event_test() {
+  EventSystem events;
+  Bool timeout = false;
+  events.Register("timeout", [&timeout](Str const &event) {
+    std::cout << "Delayed: " << event << std::endl;
+    timeout = true;
+  });
+  events.Register("cancelled", [](Str const &event) {
+    std::cout << "Cancelled event delivered: " << event << std::endl;
+  });
+
+  events.PublishAfter("timeout", 0.02);
+  Ulong timer = events.PublishAfter("cancelled", 0.01);
+  std::cout << "Cancel pending: " << events.CancelTimer(timer) << std::endl;
+  while (!timeout) {
+    events.ProcessEvents();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void coalesce_event_test() {
+  EventSystem events;
+  events.Register<CursorEvent>([](CursorEvent const &event) {
+    std::cout << "Cursor: " << event.x << ", " << event.y << std::endl;
+  });
+  events.Register<ScrollEvent>([](ScrollEvent const &event) {
+    std::cout << "Scroll: " << event.offset << std::endl;
+  });
+  events.SetCoalescing("dirty", true);
+  events.Register("dirty", [](Str const &event) {
+    std::cout << "Coalesced: " << event << std::endl;
+  });
+
+  for (int i = 0; i < 1000; ++i) {
+    events.Publish<CursorEvent>(i * 0.5, i * 0.25);
+    events.Publish<ScrollEvent>(0.5);
+    events.PublishEvent("dirty");
+  }
+  events.ProcessEvents();
+}
+
+void unregister_event_test() {
+  EventSystem events;
+  Vec<SubscriptionID> subscriptions;
+  Uint calls = 0;
+  for (int i = 0; i < 10000; ++i) {
+    subscriptions.push_back(
+        events.Register("tick", [&calls](Str const &) { ++calls; }));
+  }
+  for (int i = 0; i < 10000; i += 2) {
+    events.Unregister(subscriptions[i]);
+  }
+  std::cout << "Stale unregister: " << events.Unregister(subscriptions[0])
+            << std::endl;
+
+  // Callbacks may unregister themselves while events are dispatched.
+  SubscriptionID once = 0;
+  once = events.Register("tick", [&events, &once](Str const &event) {
+    std::cout << "Once: " << event << std::endl;
+    events.Unregister(once);
+  });
+
+  events.PublishEvent("tick");
+  events.PublishEvent("tick");
+  events.ProcessEvents();
+  std::cout << "Remaining calls: " << calls << std::endl;
+
+  // Removing the last handler and another one in the same dispatch swaps a
+  // pending removal into the freed position.
+  SubscriptionID first = 0;
+  SubscriptionID last = 0;
+  events.Register("burst", [&events, &first, &last](Str const &) {
+    events.Unregister(first);
+    events.Unregister(last);
+  });
+  first = events.Register("burst", [](Str const &) {});
+  events.Register("burst", [](Str const &) {});
+  last = events.Register("burst", [](Str const &) {});
+  events.PublishEvent("burst");
+  events.ProcessEvents();
+  std::cout << "Burst unregister: " << events.Unregister(first) << " "
+            << events.Unregister(last) << std::endl;
+}
+
+void metrics_event_test() {
+  EventSystem events;
+  events.EnableMetrics();
+  events.Register("physics", [](Str const &) {});
+  SubscriptionID slow = events.Register("physics", [](Str const &) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  });
+
+  for (int frame = 0; frame < 3; ++frame) {
+    events.PublishEvent("physics");
+    events.PublishEvent("physics");
+    events.ProcessEvents();
+  }
+  std::cout << "Dispatched: "
+            << events.GetMetrics(events.GetEventID("physics")).dispatched
+            << std::endl;
+  std::cout << "Slow handler calls: "
+            << events.GetHandlerMetrics(slow).calls << std::endl;
+  std::cout << events.DumpMetrics();
+}
+
+void topic_event_test() {
+  EventSystem events;
+  events.Register("net.player.*", [](Str const &event) {
+    std::cout << "Player: " << event << std::endl;
+  });
+  events.Register("input.key.#", [](Str const &event) {
+    std::cout << "Key: " << event << std::endl;
+  });
+  SubscriptionID any = events.Register("#.error", [](Str const &event) {
+    std::cout << "Error: " << event << std::endl;
+  });
+
+  events.PublishEvent("net.player.join");
+  events.PublishEvent("net.player.join.late");
+  events.PublishEvent("input.key");
+  events.PublishEvent("input.key.down.a");
+  events.PublishEvent("net.error");
+  events.ProcessEvents();
+
+  // Resolved patterns are cached, so the second frame skips the trie.
+  events.Unregister(any);
+  events.PublishEvent("net.player.leave");
+  events.PublishEvent("net.error");
+  events.ProcessEvents();
+}
+
+void ordered_event_test() {
+  EventSystem events;
+  events.SetTimeOrdering(true);
+  Vec<Str> received;
+  for (char const *name : {"first", "second", "third"}) {
+    events.Register(name, [&received](Str const &event) {
+      received.push_back(event);
+    });
+  }
+
+  // Each thread publishes into its own buffer without a shared lock.
+  events.PublishEvent("first");
+  Thread worker([&events]() { events.PublishEvent("second"); });
+  worker.join();
+  events.PublishEvent("third");
+  events.ProcessEvents();
+
+  std::cout << "Order:";
+  for (Str const &event : received) {
+    std::cout << " " << event;
+  }
+  std::cout << std::endl;
+
+  // Coalesced events keep the position of their first publish.
+  EventSystem fifo;
+  received.clear();
+  for (char const *name : {"first", "second", "third"}) {
+    fifo.Register(name, [&received](Str const &event) {
+      received.push_back(event);
+    });
+  }
+  fifo.SetCoalescing("second", true);
+  fifo.PublishEvent("first");
+  fifo.PublishEvent("second");
+  fifo.PublishEvent("third");
+  fifo.PublishEvent("second");
+  fifo.ProcessEvents();
+
+  std::cout << "FIFO order:";
+  for (Str const &event : received) {
+    std::cout << " " << event;
+  }
+  std::cout << std::endl;
+}
+
+void exited_publisher_event_test() {
+  EventSystem events;
+  Uint received = 0;
+  events.Register<ResizeEvent>(
+      [&received](ResizeEvent const &) { ++received; });
+
+  // Short-lived publishers leave their buffers behind when they exit.
+  for (int i = 0; i < 3; ++i) {
+    Thread publisher([&events, i]() {
+      events.Publish<ResizeEvent>((Uint)i, (Uint)i);
+    });
+    publisher.join();
+  }
+  std::cout << "Buffers after publish: " << events.GetNumPublishBuffers()
+            << std::endl;
+  events.ProcessEvents();
+  events.ProcessEvents();
+  std::cout << "Received: " << received
+            << ", buffers after dispatch: " << events.GetNumPublishBuffers()
+            << std::endl;
+}
+
+int main() {
+  event_test();
+  typed_event_test();
+  concurrent_event_test();
+  delayed_event_test();
+  coalesce_event_test();
+  unregister_event_test();
+  metrics_event_test();
+  topic_event_test();
+  ordered_event_test();
+  exited_publisher_event_test();
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include "../includes/inputTest.hpp"
+
+using namespace TerreateCore::Core;
+using namespace TerreateCore::Job;
+
+void ring_test() {
+  InputRing ring(6);
+  std::cout << "Capacity: " << ring.GetCapacity() << std::endl;
+
+  Ulong reader = ring.GetEnd();
+  for (int i = 0; i < 12; ++i) {
+    InputEvent event;
+    event.time = InputRing::GetTimestamp();
+    event.type = i % 2 == 0 ? InputEventType::KEY : InputEventType::CHAR;
+    event.code = 'a' + i;
+    ring.Push(event);
+  }
+
+  // The reader fell behind, so it resumes at the oldest event still held.
+  InputEvent event;
+  std::cout << "Read:";
+  while (ring.Next(reader, event)) {
+    std::cout << " " << (char)event.code;
+  }
+  std::cout << std::endl;
+  std::cout << "Begin: " << ring.GetBegin() << ", end: " << ring.GetEnd()
+            << ", reader: " << reader << std::endl;
+}
+
+void snapshot_test() {
+  JobSystem jobs;
+  InputSnapshotRing snapshots;
+  InputSnapshot live;
+  Atomic<Uint> consistent = 0;
+  Uint const frames = 200;
+  InputSnapshotPin held;
+  for (Uint frame = 1; frame <= frames; ++frame) {
+    live.frame = frame;
+    live.cursor = Pair<double>(frame, -(double)frame);
+    live.keys[(Uint)Keyboard::K_SPACE] = frame % 2 == 0;
+    snapshots.Publish(live);
+    if (frame == 1) {
+      // A pinned snapshot is not overwritten by later publishes.
+      held = snapshots.Get();
+    }
+
+    // Frame jobs read the snapshot without locks and without GLFW.
+    JobGroup group(jobs);
+    for (int i = 0; i < 4; ++i) {
+      group.Submit([&snapshots, &consistent] {
+        InputSnapshotPin const snapshot = snapshots.Get();
+        Bool const space = snapshot->IsPressing(Keyboard::K_SPACE);
+        if (snapshot->cursor.first == -snapshot->cursor.second &&
+            space == (snapshot->frame % 2 == 0)) {
+          ++consistent;
+        }
+      });
+    }
+    group.Wait();
+  }
+  std::cout << "Consistent snapshots: " << consistent << "/" << frames * 4
+            << std::endl;
+  std::cout << "Held snapshot frame: " << held->frame << std::endl;
+
+  // With every spare slot pinned the publish is dropped, not waited on.
+  Vec<InputSnapshotPin> pins;
+  Uint dropped = 0;
+  for (Uint frame = 1; frame <= 16; ++frame) {
+    live.frame = frames + frame;
+    if (!snapshots.Publish(live)) {
+      ++dropped;
+    }
+    pins.push_back(snapshots.Get());
+  }
+  std::cout << "Dropped publishes: " << dropped
+            << ", latest frame: " << snapshots.Get()->frame << std::endl;
+}
+
+int main() {
+  ring_test();
+  snapshot_test();
+  return 0;
+}
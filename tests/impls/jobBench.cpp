@@ -0,0 +1,261 @@
+#include "../includes/jobBench.hpp"
+
+using namespace TerreateCore::Job;
+
+struct NamedPolicy {
+  Str name;
+  IdlePolicy policy;
+};
+
+Vec<BenchResult> sResults;
+
+Vec<NamedPolicy> GetPolicies() {
+  IdlePolicy park;
+  park.maxSpins = 0;
+  park.minSpins = 0;
+  park.yields = 0;
+  park.adaptive = false;
+
+  IdlePolicy spin;
+  spin.maxSpins = 1 << 16;
+  spin.minSpins = 1 << 16;
+  spin.adaptive = false;
+
+  return {{"park", park}, {"adaptive", IdlePolicy()}, {"spin", spin}};
+}
+
+Vec<Uint> GetThreadCounts() {
+  Uint const hardware = std::max(1u, std::thread::hardware_concurrency());
+  Vec<Uint> counts;
+  for (Uint count = 1; count < hardware; count *= 2) {
+    counts.push_back(count);
+  }
+  counts.push_back(hardware);
+  return counts;
+}
+
+// Waits without helping, so the sample measures how fast a worker reacts.
+void WaitFinished(JobBase const &job) {
+  while (!job.IsFinished()) {
+    std::this_thread::yield();
+  }
+}
+
+Vec<Double> MeasureWakeLatency(JobSystem &jobs, Uint const &iterations,
+                               std::chrono::microseconds const &gap) {
+  Vec<Double> samples;
+  Atomic<Long> started = 0;
+  SimpleJob job([&started] { started.store(Now()); });
+
+  for (Uint i = 0; i < iterations; ++i) {
+    std::this_thread::sleep_for(gap);
+    started.store(0);
+    Long const scheduled = Now();
+    jobs.Schedule(&job);
+    WaitFinished(job);
+    samples.push_back(ToMicroseconds(started.load() - scheduled));
+  }
+  jobs.WaitForAll();
+  return samples;
+}
+
+void wake_latency_bench() {
+  for (NamedPolicy const &entry : GetPolicies()) {
+    JobSystem jobs(2, entry.policy);
+    sResults.push_back({"wake_burst", entry.name,
+                        MeasureWakeLatency(jobs, 1000,
+                                           std::chrono::microseconds(0)),
+                        0.0});
+    sResults.push_back({"wake_after_idle", entry.name,
+                        MeasureWakeLatency(jobs, 200,
+                                           std::chrono::microseconds(2000)),
+                        0.0});
+  }
+}
+
+void idle_cpu_bench() {
+  for (NamedPolicy const &entry : GetPolicies()) {
+    JobSystem jobs(std::thread::hardware_concurrency(), entry.policy);
+    SimpleJob job([] {});
+    for (int i = 0; i < 1000; ++i) {
+      jobs.Schedule(&job);
+      jobs.WaitForAll();
+    }
+
+    std::clock_t const cpuStart = std::clock();
+    auto const wallStart = SteadyClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    Double const cpu = (Double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    Double const wall =
+        std::chrono::duration<Double>(SteadyClock::now() - wallStart).count();
+    // Throughput holds the idle cpu usage in percent of one core.
+    sResults.push_back({"idle_cpu", entry.name, {}, cpu / wall * 100.0});
+  }
+}
+
+void throughput_bench() {
+  Size const numJobs = 100000;
+  Vec<Long> scheduled(numJobs);
+  Vec<Long> started(numJobs);
+  Vec<Shared<SimpleJob>> batch;
+  for (Size i = 0; i < numJobs; ++i) {
+    batch.push_back(std::make_shared<SimpleJob>(
+        [&started, i] { started[i] = Now(); }));
+  }
+
+  for (Uint const &count : GetThreadCounts()) {
+    JobSystem jobs(count);
+    Long const begin = Now();
+    for (Size i = 0; i < numJobs; ++i) {
+      scheduled[i] = Now();
+      jobs.Schedule(batch[i].get());
+    }
+    jobs.WaitForAll();
+    Long const end = Now();
+
+    BenchResult result{"empty_jobs", "workers=" + std::to_string(count), {},
+                       0.0};
+    for (Size i = 0; i < numJobs; ++i) {
+      result.samples.push_back(ToMicroseconds(started[i] - scheduled[i]));
+    }
+    result.throughput = numJobs / (ToMicroseconds(end - begin) / 1e6);
+    sResults.push_back(result);
+  }
+}
+
+void chain_bench() {
+  Size const length = 1000;
+  JobSystem jobs;
+  BenchResult result{"dependency_chain", "length=" + std::to_string(length), {},
+                     0.0};
+  for (int run = 0; run < 10; ++run) {
+    Shared<Vec<Long>> stamps = std::make_shared<Vec<Long>>(length + 1);
+    Future<Size> link = jobs.Submit([stamps] {
+      (*stamps)[0] = Now();
+      return (Size)0;
+    });
+    for (Size i = 0; i < length; ++i) {
+      link = link.Then(jobs, [stamps](Size const &step) {
+        (*stamps)[step + 1] = Now();
+        return step + 1;
+      });
+    }
+    link.Wait();
+
+    // Each sample is the latency of one continuation hop.
+    for (Size i = 0; i < length; ++i) {
+      result.samples.push_back(ToMicroseconds((*stamps)[i + 1] - (*stamps)[i]));
+    }
+  }
+  sResults.push_back(result);
+}
+
+void fan_bench() {
+  JobSystem jobs;
+  for (Size width : {8, 64, 256}) {
+    TaskGraph graph;
+    Atomic<Size> counter = 0;
+    Index source = graph.AddTask("source", [] {}, TaskAffinity::CALLER);
+    Index sink = graph.AddTask("sink", [] {}, TaskAffinity::CALLER);
+    for (Size i = 0; i < width; ++i) {
+      Index task = graph.AddTask("work", [&counter] { counter++; });
+      graph.AddEdge(source, task);
+      graph.AddEdge(task, sink);
+    }
+
+    BenchResult result{"fan_out_in", "width=" + std::to_string(width), {}, 0.0};
+    for (int frame = 0; frame < 200; ++frame) {
+      Long const begin = Now();
+      graph.Execute(jobs);
+      result.samples.push_back(ToMicroseconds(Now() - begin));
+    }
+    sResults.push_back(result);
+  }
+}
+
+void parallel_for_bench() {
+  Size const size = 10000000;
+  Size const grain = 1 << 16;
+  Vec<float> data(size, 1.0f);
+
+  BenchResult serial{"parallel_for", "serial", {}, 0.0};
+  for (int run = 0; run < 10; ++run) {
+    Long const begin = Now();
+    for (float &value : data) {
+      value = value * 0.5f + 1.0f;
+    }
+    serial.samples.push_back(ToMicroseconds(Now() - begin));
+  }
+  serial.throughput = size / (Percentile(serial.samples, 0.5) / 1e6);
+  sResults.push_back(serial);
+
+  for (Uint const &count : GetThreadCounts()) {
+    JobSystem jobs(count);
+    BenchResult result{"parallel_for", "workers=" + std::to_string(count), {},
+                       0.0};
+    for (int run = 0; run < 10; ++run) {
+      Long const begin = Now();
+      JobGroup group(jobs);
+      for (Size offset = 0; offset < size; offset += grain) {
+        Size const end = std::min(offset + grain, size);
+        group.Submit([&data, offset, end] {
+          for (Size i = offset; i < end; ++i) {
+            data[i] = data[i] * 0.5f + 1.0f;
+          }
+        });
+      }
+      group.Wait();
+      result.samples.push_back(ToMicroseconds(Now() - begin));
+    }
+    result.throughput = size / (Percentile(result.samples, 0.5) / 1e6);
+    sResults.push_back(result);
+  }
+}
+
+void mixed_bench() {
+  // There are no priority levels, so this measures how long short,
+  // latency-sensitive jobs wait behind long background jobs.
+  for (Size background : {0, 16, 64}) {
+    JobSystem jobs;
+    JobGroup heavy(jobs);
+    for (Size i = 0; i < background; ++i) {
+      heavy.Submit([] {
+        Long const end = Now() + 2000000;
+        while (Now() < end) {
+        }
+      });
+    }
+
+    BenchResult result{"mixed", "background=" + std::to_string(background), {},
+                       0.0};
+    for (int i = 0; i < 200; ++i) {
+      Atomic<Long> started = 0;
+      SimpleJob job([&started] { started.store(Now()); });
+      Long const scheduled = Now();
+      jobs.Schedule(&job);
+      WaitFinished(job);
+      result.samples.push_back(ToMicroseconds(started.load() - scheduled));
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    heavy.Wait();
+    jobs.WaitForAll();
+    sResults.push_back(result);
+  }
+}
+
+int main(int argc, char **argv) {
+  wake_latency_bench();
+  idle_cpu_bench();
+  throughput_bench();
+  chain_bench();
+  fan_bench();
+  parallel_for_bench();
+  mixed_bench();
+
+  WriteReport(std::cout, sResults);
+  if (argc > 1) {
+    std::ofstream file(argv[1]);
+    WriteReport(file, sResults);
+  }
+  return 0;
+}
@@ -33,7 +33,197 @@ void job_test() {
   jobs.WaitForAll();
 }
 
+void future_test() {
+  JobSystem jobs;
+  Job<int> answer([] { return 42; });
+  jobs.Schedule(&answer);
+  std::cout << "Job<int>: " << answer.GetFuture().Get() << std::endl;
+
+  Future<Str> text = jobs.Submit([] { return 21; }).Then(jobs, [](int value) {
+    return std::to_string(value * 2);
+  });
+  std::cout << "Then: " << text.Get() << std::endl;
+
+  Vec<Future<int>> futures;
+  for (int i = 0; i < 4; ++i) {
+    futures.push_back(jobs.Submit([i] { return i * i; }));
+  }
+  Future<Vec<int>> all = WhenAll(futures);
+  for (int value : all.Get()) {
+    std::cout << "WhenAll: " << value << std::endl;
+  }
+  std::cout << "WhenAny: " << WhenAny(futures).Get() << std::endl;
+
+  Future<int> failed = jobs.Submit([]() -> int {
+    throw std::runtime_error("Job failed");
+  });
+  try {
+    failed.Then(jobs, [](int value) { return value + 1; }).Get();
+  } catch (std::exception const &e) {
+    std::cout << "Rethrown: " << e.what() << std::endl;
+  }
+
+  Future<int> uploaded = jobs.Submit([] { return 1; })
+                            .ThenOnContext(jobs, [](int value) {
+                              return value + 1;
+                            });
+  while (!uploaded) {
+    jobs.ProcessContextJobs(0.002);
+  }
+  std::cout << "ThenOnContext: " << uploaded.Get() << std::endl;
+
+  jobs.WaitForAll();
+}
+
+void graph_test() {
+  JobSystem jobs;
+  TaskGraph graph;
+  Atomic<int> counter = 0;
+  auto work = [&counter] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    counter++;
+  };
+
+  Index input = graph.AddTask("input", work, TaskAffinity::CALLER);
+  Index culling = graph.AddTask("culling", work);
+  Index animation = graph.AddTask("animation", work);
+  Index render = graph.AddTask("render", work, TaskAffinity::CALLER);
+  graph.AddEdge(input, culling);
+  graph.AddEdge(input, animation);
+  graph.AddEdge(culling, render);
+  graph.AddEdge(animation, render);
+
+  jobs.EnableTracing();
+  for (int frame = 0; frame < 3; ++frame) {
+    graph.Execute(jobs);
+  }
+  jobs.DisableTracing();
+  jobs.ExportTrace("jobTrace.json");
+  std::cout << "TaskGraph executed tasks: " << counter << std::endl;
+
+  for (Index const &task : graph.GetCriticalPath()) {
+    std::cout << "Critical path: " << graph.GetName(task) << " "
+              << graph.GetTiming(task).GetDuration() << "ns" << std::endl;
+  }
+}
+
+void cancel_test() {
+  JobSystem jobs(1);
+  SimpleJob blocker(
+      [] { std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+  jobs.Schedule(&blocker);
+
+  CancelToken token;
+  Vec<Future<int>> futures;
+  for (int i = 0; i < 8; ++i) {
+    Job<int> *job = new Job<int>([i] { return i; });
+    job->SetCancelToken(token);
+    futures.push_back(job->GetFuture());
+    jobs.Adopt(job);
+  }
+
+  SimpleJob expired([] { std::cout << "Expired job executed" << std::endl; });
+  expired.SetTimeout(0.0);
+  jobs.Schedule(&expired);
+
+  std::cout << "Dropped jobs: " << jobs.Cancel(token) << std::endl;
+  jobs.WaitForAll();
+  std::cout << "Expired job skipped: " << expired.IsSkipped() << std::endl;
+
+  try {
+    futures[0].Get();
+  } catch (std::exception const &e) {
+    std::cout << "Cancelled: " << e.what() << std::endl;
+  }
+}
+
+void group_test() {
+  JobSystem jobs;
+  Atomic<int> sum = 0;
+  JobGroup outer(jobs);
+  for (int i = 0; i < 4; ++i) {
+    outer.Submit([&jobs, &sum] {
+      // Nested waits help executing jobs instead of blocking the worker.
+      JobGroup inner(jobs);
+      for (int j = 1; j <= 10; ++j) {
+        inner.Submit([&sum, j] { sum += j; });
+      }
+      inner.Wait();
+    });
+  }
+  outer.Wait();
+  std::cout << "Group sum: " << sum << std::endl;
+
+  JobGroup cancelled(jobs);
+  cancelled.Cancel();
+  Future<int> skipped = cancelled.Submit([] { return 1; });
+  cancelled.Wait();
+  std::cout << "Cancelled group job skipped: " << skipped.IsReady()
+            << std::endl;
+}
+
+void io_test() {
+  JobSystem jobs;
+  IOSystem io;
+  Future<Size> size = io.Read("../resources/testJson.json")
+                          .Then(jobs, [](Vec<Ubyte> const &data) {
+                            // Parsing runs on a CPU worker, not the I/O pool.
+                            return (Size)data.size();
+                          });
+  Future<Str> missing = io.ReadText("../resources/missing.json");
+  std::cout << "Read bytes: " << size.Get() << std::endl;
+  std::cout << "I/O threads: " << io.GetNumThreads() << std::endl;
+
+  try {
+    missing.Get();
+  } catch (std::exception const &e) {
+    std::cout << "Read failed: " << e.what() << std::endl;
+  }
+}
+
+void timer_test() {
+  JobSystem jobs;
+  Atomic<int> ticks = 0;
+  SimpleJob tick([&ticks] { ticks++; });
+  SimpleJob delayed([] { std::cout << "Delayed job" << std::endl; });
+
+  ID timer = jobs.ScheduleEvery(&tick, 0.016);
+  jobs.ScheduleAfter(&delayed, 0.1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  jobs.CancelTimer(timer);
+  jobs.WaitForAll();
+  std::cout << "Periodic ticks in 200ms: " << ticks << std::endl;
+}
+
+void topology_test() {
+  CpuTopology topology;
+  for (CpuInfo const &cpu : topology.GetCpus()) {
+    std::cout << "Cpu " << cpu.id << ": package " << cpu.package << ", core "
+              << cpu.core << ", node " << cpu.node << std::endl;
+  }
+
+  for (Vec<Uint> const &partition : topology.PartitionByNode()) {
+    JobSystemSettings settings;
+    settings.cpus = partition;
+    settings.reservedCpus = {partition[0]};
+    settings.pinWorkers = partition.size() > 1;
+    if (partition.size() == 1) {
+      settings.reservedCpus.clear();
+    }
+
+    JobSystem jobs(settings);
+    std::cout << "Node pool workers: " << jobs.GetNumWorkers() << std::endl;
+  }
+}
+
 int main() {
   job_test();
+  future_test();
+  graph_test();
+  cancel_test();
+  group_test();
+  io_test();
+  timer_test();
+  topology_test();
   return 0;
 }
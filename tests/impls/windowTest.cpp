@@ -33,6 +33,45 @@ public:
   }
 };
 
+class RenderThreadSet : public WindowController {
+private:
+  float s = 0.0f;
+  float f = 0.001f;
+
+public:
+  void OnFrame(Window *window) override {
+    window->PollEvents();
+    // Recorded commands run on the render thread with the context current.
+    float const shade = s;
+    window->Record([window, shade] {
+      window->Fill({shade, 0.0f, shade});
+      window->Clear();
+    });
+    s += f;
+
+    if (s > 1.0f || s < 0.0f) {
+      f = -f;
+    }
+  }
+};
+
+void render_thread_test(unsigned const &width, unsigned const &height,
+                        Str const &title) {
+  Initialize();
+  Window window = Window(width, height, title, WindowSettings());
+
+  RenderThreadSet callbackSet;
+  window.SetWindowController(&callbackSet);
+  window.StartRenderThread();
+
+  while (!window.IsClosed()) {
+    window.Frame();
+  }
+
+  window.Close();
+  Terminate();
+}
+
 void window_generation_test(unsigned const &width, unsigned const &height,
                             Str const &title) {
   Initialize();
@@ -42,6 +81,13 @@ void window_generation_test(unsigned const &width, unsigned const &height,
   window.SetWindowController(&callbackSet);
   glfwSwapInterval(0);
 
+  TerreateCore::Job::JobSystem jobs;
+  window.SetContextJobSystem(&jobs);
+  jobs.Submit([] { return Str("OpenGL version: "); })
+      .ThenOnContext(jobs, [](Str const &label) {
+        std::cout << label << glGetString(GL_VERSION) << std::endl;
+      });
+
   while (!window.IsClosed()) {
     window.Frame();
   }
@@ -51,5 +97,6 @@ void window_generation_test(unsigned const &width, unsigned const &height,
 
 int main() {
   window_generation_test(800, 600, "Window Test");
+  render_thread_test(800, 600, "Render Thread Test");
   return 0;
 }
@@ -0,0 +1,52 @@
+#pragma once
+#include "../../includes/TerreateCore.hpp"
+#include <algorithm>
+#include <chrono>
+
+using namespace TerreateCore::Defines;
+using SteadyClock = std::chrono::steady_clock;
+
+struct BenchResult {
+public:
+  Str bench;
+  Str config;
+  Vec<Double> samples;     // Microseconds.
+  Double throughput = 0.0; // Items per second, 0 when not measured.
+};
+
+inline Long Now() { return SteadyClock::now().time_since_epoch().count(); }
+
+inline Double ToMicroseconds(Long const &nanoseconds) {
+  return std::chrono::duration<Double, std::micro>(
+             SteadyClock::duration(nanoseconds))
+      .count();
+}
+
+inline Double Percentile(Vec<Double> samples, Double const &percentile) {
+  if (samples.empty()) {
+    return 0.0;
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples[(Size)(percentile * (samples.size() - 1))];
+}
+
+// Writes the results as a JSON array, one object per result.
+inline void WriteReport(std::ostream &stream,
+                        Vec<BenchResult> const &results) {
+  stream << "[\n";
+  for (Size i = 0; i < results.size(); ++i) {
+    BenchResult const &result = results[i];
+    Double mean = 0.0;
+    for (Double const &sample : result.samples) {
+      mean += sample / result.samples.size();
+    }
+    stream << "  {\"bench\": \"" << result.bench << "\", \"config\": \""
+           << result.config << "\", \"samples\": " << result.samples.size()
+           << ", \"p50_us\": " << Percentile(result.samples, 0.5)
+           << ", \"p99_us\": " << Percentile(result.samples, 0.99)
+           << ", \"mean_us\": " << mean
+           << ", \"throughput\": " << result.throughput << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  stream << "]" << std::endl;
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include "../../includes/TerreateCore.hpp"
+
+void frame_test();
+void fixed_step_test();
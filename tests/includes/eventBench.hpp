@@ -0,0 +1,4 @@
+#pragma once
+#include "benchReport.hpp"
+
+void publish_bench();
@@ -0,0 +1,13 @@
+#pragma once
+#include "../../includes/TerreateCore.hpp"
+
+void event_test();
+void typed_event_test();
+void concurrent_event_test();
+void delayed_event_test();
+void coalesce_event_test();
+void unregister_event_test();
+void metrics_event_test();
+void topic_event_test();
+void ordered_event_test();
+void exited_publisher_event_test();
@@ -0,0 +1,5 @@
+#pragma once
+#include "../../includes/TerreateCore.hpp"
+
+void ring_test();
+void snapshot_test();
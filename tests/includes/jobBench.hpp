@@ -0,0 +1,11 @@
+#pragma once
+#include "benchReport.hpp"
+#include <ctime>
+
+void wake_latency_bench();
+void idle_cpu_bench();
+void throughput_bench();
+void chain_bench();
+void fan_bench();
+void parallel_for_bench();
+void mixed_bench();
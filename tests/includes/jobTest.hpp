@@ -3,3 +3,10 @@
 #include <chrono>
 
 void job_test();
+void future_test();
+void graph_test();
+void cancel_test();
+void group_test();
+void io_test();
+void timer_test();
+void topology_test();
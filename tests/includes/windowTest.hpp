@@ -5,3 +5,5 @@
 
 void window_generation_test(unsigned const &width, unsigned const &height,
                             TerreateCore::Defines::Str const &title);
+void render_thread_test(unsigned const &width, unsigned const &height,
+                        TerreateCore::Defines::Str const &title);